@@ -6,20 +6,68 @@
 
 #pragma  once
 
+#include "bus/can_filter.hpp"
+
 #include <array>
+#include <memory>
 #include <cstdint>
+#include <cstddef>
+#include <span>
 #include <string_view>
 #include <vector>
 #include <chrono>
+#include <type_traits>
 
 namespace canmqtt::bus 
 {
 
-struct Frame {
-    uint32_t id                 {};                       ///< 11-/29-bit identifier
-    std::vector<uint8_t> data   {};                       ///< payload (0-8 B for classic)
+inline constexpr std::size_t kRxBatchSize = 64;           ///< readBatch için önerilen tampon boyu
+
+/// Tek CAN/CAN FD frame'i. Heap kullanmaz, trivially-copyable: kuyruk ve
+/// ring buffer'larda memcpy ile taşınabilir. Başlık + payload'ın ilk 48 baytı
+/// ilk cache line'a düşer; klasik (8 B) frame'ler tek line'a sığar.
+struct alignas(64) Frame {
+    static constexpr std::size_t kMaxData = 64;           ///< CAN FD azami payload
+
+    enum Flags : uint8_t {
+        kExt = 1u << 0,                                   ///< 29-bit identifier
+        kRtr = 1u << 1,                                   ///< remote request
+        kFd  = 1u << 2,                                   ///< CAN FD frame
+        kBrs = 1u << 3,                                   ///< FD bit rate switch
+        kErr = 1u << 4,                                   ///< error frame
+        kEsi = 1u << 5,                                   ///< FD error state indicator
+        kTp  = 1u << 6,                                   ///< J1939 TP ile birleştirilmiş mantıksal mesaj
+    };
+
+    uint32_t id                 {};                       ///< 11-/29-bit identifier (bayrak bitleri yok)
+    uint8_t  len                {};                       ///< payload uzunluğu (0-64)
+    uint8_t  flags              {};                       ///< Flags bit maskesi
+    uint8_t  channel            {};                       ///< okunduğu kanal indeksi
+    uint8_t  reserved           {};
     std::chrono::microseconds ts{};                       ///< monotonic timestamp
+    uint8_t  data[kMaxData]     {};                       ///< payload; [len, 8) arası sıfır tutulur
+
+    std::span<const uint8_t> payload() const { return {data, len}; }
+    bool extended() const { return flags & kExt; }
+
+    /// SocketCAN/DBC biçimindeki ID (29-bit ise bit31 = CAN_EFF_FLAG)
+    uint32_t rawId() const { return extended() ? (id | 0x80000000u) : id; }
 };
+static_assert(std::is_trivially_copyable_v<Frame>);
+static_assert(sizeof(Frame) == 128);
+
+/// CAN FD DLC kodu → bayt uzunluğu (ISO 11898-1)
+inline constexpr uint8_t kFdDlcLength[16] = {0,1,2,3,4,5,6,7,8,12,16,20,24,32,48,64};
+
+inline constexpr uint8_t FdDlcToLen(uint8_t dlc) { return kFdDlcLength[dlc & 0x0F]; }
+
+/// len baytı taşıyabilen en küçük DLC (64'ten büyükse 15)
+inline constexpr uint8_t FdLenToDlc(std::size_t len)
+{
+    for (uint8_t d = 0; d < 16; ++d)
+        if (kFdDlcLength[d] >= len) return d;
+    return 15;
+}
 
 class ICanChannel {
     public:
@@ -28,8 +76,39 @@ class ICanChannel {
         virtual bool read(Frame& out) = 0;
         virtual void close() = 0;
 
-    // Factory: yapılandırma ile dinamik backend seçimi
-    static ICanChannel* create(std::string_view backend);
+        /// Tek çağrıda en fazla out.size() frame okur; count = doldurulan adet.
+        /// Zaman aşımında true + count=0 döner, false yalnızca kalıcı hata demektir.
+        /// Backend'ler toplu okuma destekliyorsa override eder (örn. recvmmsg).
+        virtual bool readBatch(std::span<Frame> out, std::size_t& count) {
+            count = 0;
+            if (out.empty()) return true;
+            if (!read(out.front())) return false;
+            count = 1;
+            return true;
+        }
+
+        /// nativeHandle() hazır bildirildikten sonra çağrılır (epoll): yalnızca
+        /// bekleyenleri alır, hiç beklemez. Tanıtıcı hazırken readBatch()'i
+        /// zaten hemen dönen backend'ler override etmez.
+        virtual bool drain(std::span<Frame> out, std::size_t& count) { return readBatch(out, count); }
+
+        /// Kernel/adaptör kuyruğunda taşma nedeniyle kaybolan toplam frame sayısı.
+        virtual uint64_t droppedFrames() const { return 0; }
+
+        /// epoll/poll ile beklenebilecek tanıtıcı (SocketCAN soketi);
+        /// -1 ise kanal yalnızca bloklayan readBatch() ile okunur.
+        virtual int nativeHandle() const { return -1; }
+
+        /// Kabul filtrelerini kernel'e/adaptöre yükler (open() sonrası).
+        /// Desteklemeyen ya da uygulayamayan backend false döner; bu durumda
+        /// tüm trafik gelmeye devam eder.
+        virtual bool setFilters(std::span<const CanFilter> filters) { (void)filters; return false; }
+
+    // Factory: yapılandırma ile dinamik backend seçimi. Her çağrı yeni bir
+    // kanal üretir; section, backend'e özgü ayarların (bitrate vb.) okunacağı
+    // config bölümüdür.
+    static std::unique_ptr<ICanChannel> create(std::string_view backend,
+                                               std::string_view section = "can");
 
         // non-copyable
         ICanChannel(const ICanChannel&)            = delete;
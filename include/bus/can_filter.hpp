@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace canmqtt::bus {
+
+inline constexpr uint32_t    kFilterEff     = 0x80000000u;  ///< CAN_EFF_FLAG: 29-bit frame
+inline constexpr uint32_t    kSffMask       = 0x000007FFu;
+inline constexpr uint32_t    kEffMask       = 0x1FFFFFFFu;
+inline constexpr uint32_t    kJ1939PgnMask  = 0x03FFFF00u;  ///< öncelik ve SA hariç (DP|PF|PS)
+inline constexpr uint32_t    kJ1939PfMask   = 0x00FF0000u;  ///< yalnızca PF (PDU1: DA ve SA önemsiz)
+inline constexpr std::size_t kMaxFilters    = 512;          ///< CAN_RAW_FILTER_MAX
+
+/// SocketCAN semantiğinde kabul filtresi: (rawId & mask) == (id & mask).
+/// id/mask bit31'i (kFilterEff) frame tipini ayırır; invert = CAN_INV_FILTER.
+struct CanFilter {
+    uint32_t id   {};
+    uint32_t mask {};
+    bool     invert {false};
+
+    bool matches(uint32_t rawId) const { return ((rawId & mask) == (id & mask)) != invert; }
+    bool operator==(const CanFilter&) const = default;
+};
+
+/// Her 11- ve 29-bit frame'i kabul eder: yüklü filtreleri kaldırmak için setFilters'a verilir
+inline constexpr CanFilter kAcceptAll[2] = {{0, kFilterEff}, {kFilterEff, kFilterEff}};
+
+/// Tek ID için tam eşleşme filtresi (ID > 0x7FF ise 29-bit kabul edilir)
+CanFilter ExactFilter(uint32_t id, bool extended);
+
+/// "18FEF100, 0x123, 0CF00400/03FFFF00" biçimindeki listeyi ekler.
+/// ID > 0x7FF ya da bit31'i set ise 29-bit; maske verilmezse tam eşleşme.
+/// Hatalı girdi atlanır; en az biri hatalıysa false.
+bool ParseFilterList(std::string_view text, std::vector<CanFilter>& out);
+
+/// Kabul kümesini değiştirmeden birleştirir (tek bit farklı çiftler, kapsananlar),
+/// hâlâ maxCount'tan fazlaysa en düşük bitlerden başlayarak maskeyi gevşetir:
+/// sonuç girdinin kabul ettiği her ID'yi kabul eder, fazlasını da edebilir.
+std::vector<CanFilter> CompactFilters(std::vector<CanFilter> filters, std::size_t maxCount = kMaxFilters);
+
+} // namespace canmqtt::bus
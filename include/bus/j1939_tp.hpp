@@ -0,0 +1,109 @@
+#pragma once
+
+#include "bus/can_channel.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace canmqtt::bus {
+
+/// J1939-21 taşıma protokolü (TP.CM / TP.DT) birleştirici.
+///
+/// Çok paketli PGN'ler (DM1, VIN, yazılım kimliği...) BAM ya da RTS/CTS ile
+/// 7 baytlık TP.DT parçalarına bölünür. TP.DT PGN taşımaz; oturum, frame'in
+/// (kanal, SA, DA) üçlüsüyle bulunur ve PGN TP.CM'den saklanır (J1939 bir
+/// çift arasında aynı anda tek oturuma izin verir). Oturumlar sabit boyutlu
+/// havuzdan alınır, tamponlar (1785 B) ve indeks bir kez ayrılır; kararlı
+/// durumda heap'e dokunulmaz. Thread-safe değildir: her işçinin kendi örneği
+/// vardır ve aynı SA'nın TP frame'leri hep aynı işçiye yönlendirilir.
+class J1939Reassembler {
+public:
+    static constexpr std::size_t kMaxPackets = 255;
+    static constexpr std::size_t kMaxPayload = kMaxPackets * 7;   ///< 1785
+
+    enum class Result {
+        NotTp,      ///< TP frame'i değil: normal yoldan çözülmeli
+        Consumed,   ///< oturuma işlendi (ya da geçersiz/bilinmeyen oturum)
+        Complete,   ///< out doldu: mantıksal mesaj hazır
+    };
+
+    /// Birleştirilmiş mesaj; data bir sonraki feed() çağrısına kadar geçerli
+    struct Message {
+        uint32_t id {};                      ///< öncelik | PGN | (PDU1'de DA) | SA, bayraksız 29-bit
+        uint8_t  channel {};
+        std::chrono::microseconds ts {};     ///< son TP.DT'nin zamanı
+        std::span<const uint8_t> data;
+    };
+
+    struct Stats {
+        uint64_t completed {};
+        uint64_t timedOut {};
+        uint64_t aborted {};
+        uint64_t noSession {};               ///< havuz dolu ya da TP.CM'siz TP.DT
+        uint64_t invalid {};                 ///< tutarsız TP.CM / sıra numarası
+    };
+
+    explicit J1939Reassembler(std::size_t maxSessions = 256,
+                              std::chrono::milliseconds timeout = std::chrono::milliseconds(750));
+
+    J1939Reassembler(const J1939Reassembler&)            = delete;
+    J1939Reassembler& operator=(const J1939Reassembler&) = delete;
+
+    /// 29-bit ve PF = 0xEC (TP.CM) ya da 0xEB (TP.DT)
+    static bool isTp(const Frame& f)
+    {
+        if (!f.extended()) return false;
+        const uint32_t pf = (f.id >> 16) & 0xFF;
+        return pf == 0xEC || pf == 0xEB;
+    }
+
+    Result feed(const Frame& f, Message& out);
+
+    /// Son TP.DT'sinden bu yana timeout geçmiş oturumları bırakır
+    void expire(std::chrono::microseconds now);
+
+    std::size_t active() const { return used_; }
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Session {
+        uint32_t key {};                     ///< kanal<<16 | SA<<8 | DA
+        uint32_t pgn {};
+        uint16_t size {};
+        uint8_t  packets {};
+        uint8_t  received {};
+        uint8_t  priority {};
+        bool     active {false};
+        std::chrono::microseconds last {};
+        uint64_t have[4] {};                 ///< alınan paketlerin bit haritası (tekrarlar sayılmaz)
+        uint8_t  data[kMaxPayload] {};
+    };
+
+    static constexpr uint16_t kEmpty = 0xFFFF;
+
+    static uint32_t makeKey(uint8_t channel, uint8_t sa, uint8_t da)
+    {
+        return (uint32_t{channel} << 16) | (uint32_t{sa} << 8) | da;
+    }
+
+    Result onControl(const Frame& f, uint8_t sa, uint8_t da);
+    Result onData(const Frame& f, uint8_t sa, uint8_t da, Message& out);
+
+    Session* find(uint32_t key);
+    Session* acquire(uint32_t key);
+    void release(Session& s);
+    std::size_t slotOf(uint32_t key) const { return (key * 0x9E3779B1u) >> shift_ & mask_; }
+
+    std::vector<Session> pool_;
+    std::vector<uint16_t> free_;
+    std::vector<uint16_t> table_;            ///< açık adresleme (doğrusal yoklama) → pool_ indeksi
+    std::size_t mask_ {0};
+    int shift_ {0};
+    std::size_t used_ {0};
+    std::chrono::microseconds timeout_;
+    Stats stats_;
+};
+
+} // namespace canmqtt::bus
@@ -2,7 +2,9 @@
 #pragma once
 
 #include "bus/can_channel.hpp"
+#include <chrono>
 #include <cstdint>
+#include <string>
 #include <string_view>
 #include <vector>
 #include <memory>
@@ -18,7 +20,37 @@ namespace canmqtt::bus {
 
 // PCANBasic sabitleri (PCANBasic.h içinden alınan gerekli kısımlar)
 enum PcanStatus : uint32_t {
-    PCAN_ERROR_OK = 0x00000,
+    PCAN_ERROR_OK        = 0x00000,
+    PCAN_ERROR_XMTFULL   = 0x00001,
+    PCAN_ERROR_OVERRUN   = 0x00002,  // CAN denetleyicisi okunamadan taştı
+    PCAN_ERROR_BUSLIGHT  = 0x00004,
+    PCAN_ERROR_BUSHEAVY  = 0x00008,
+    PCAN_ERROR_BUSOFF    = 0x00010,
+    PCAN_ERROR_QRCVEMPTY = 0x00020,  // alım kuyruğu boş: hata değil
+    PCAN_ERROR_QOVERRUN  = 0x00040,  // alım kuyruğu taştı
+};
+
+// TPCANMessageType bitleri
+enum PcanMsgType : uint8_t {
+    PCAN_MESSAGE_STANDARD = 0x00,
+    PCAN_MESSAGE_RTR      = 0x01,
+    PCAN_MESSAGE_EXTENDED = 0x02,
+    PCAN_MESSAGE_FD       = 0x04,
+    PCAN_MESSAGE_BRS      = 0x08,
+    PCAN_MESSAGE_ESI      = 0x10,
+    PCAN_MESSAGE_ERRFRAME = 0x40,
+    PCAN_MESSAGE_STATUS   = 0x80,
+};
+
+// TPCANParameter / TPCANMode (yalnızca kullanılanlar; değerler PCANBasic.h ile aynı)
+enum PcanParameter : uint8_t {
+    PCAN_RECEIVE_EVENT           = 0x03,  // Linux: okunabilir fd (Get), Windows: event HANDLE (Set)
+    PCAN_ACCEPTANCE_FILTER_11BIT = 0x22,  // 64 bit: kod (üst 32) | maske (alt 32), maske 1 = önemsiz
+    PCAN_ACCEPTANCE_FILTER_29BIT = 0x23,
+};
+enum PcanMode : uint8_t {
+    PCAN_MODE_STANDARD = 0x00,
+    PCAN_MODE_EXTENDED = 0x02,
 };
 
 // Kanal tipi (donanım handle). PCANBasic'te TPCANHandle = uint16_t
@@ -27,44 +59,112 @@ using PcanHandle = uint16_t;
 // PCANBasic message struct (TPCANMsg)
 struct PcanMsg {
     uint32_t id;      // 11/29 bit
-    uint8_t  msgtype; // bit field (RTR, EXT, FD vs.) – şu an sadece EXT kontrol ederiz.
+    uint8_t  msgtype; // bit field (RTR, EXT, FD vs.)
     uint8_t  len;     // DLC
-    uint8_t  data[64];// FD için geniş tuttuk; klasik kullanımda ilk 8
+    uint8_t  data[8];
 };
 
+// TPCANTimestamp: µs = micros + 1000 * millis + 0x100000000 * 1000 * millis_overflow
+struct PcanTimestamp {
+    uint32_t millis;
+    uint16_t millis_overflow;
+    uint16_t micros;
+};
+
+// PCANBasic FD message struct (TPCANMsgFD)
+struct PcanMsgFD {
+    uint32_t id;      // 11/29 bit
+    uint8_t  msgtype; // bit field (RTR, EXT, FD, BRS, ESI)
+    uint8_t  dlc;     // DLC kodu (0-15), uzunluk değil
+    uint8_t  data[64];
+};
+using PcanTimestampFD = uint64_t; // mikro saniye
+
 // Fonksiyon pointer'ları (Windows'ta PCANBasic __stdcall kullanır)
 #if defined(_WIN32)
     #define PCAN_CALL __stdcall
 #else
     #define PCAN_CALL
 #endif
-using CAN_Initialize_t   = PcanStatus(PCAN_CALL *)(PcanHandle, uint16_t, uint32_t, uint8_t, uint8_t, uint8_t);
+using CAN_Initialize_t   = PcanStatus(PCAN_CALL *)(PcanHandle, uint16_t /*Btr0Btr1*/, uint8_t /*HwType*/, uint32_t /*IOPort*/, uint16_t /*Interrupt*/);
+using CAN_InitializeFD_t = PcanStatus(PCAN_CALL *)(PcanHandle, const char* /*TPCANBitrateFD*/);
 using CAN_Uninitialize_t = PcanStatus(PCAN_CALL *)(PcanHandle);
-using CAN_Read_t         = PcanStatus(PCAN_CALL *)(PcanHandle, PcanMsg*, void* /*TPCANTimestamp**/);
+using CAN_Read_t         = PcanStatus(PCAN_CALL *)(PcanHandle, PcanMsg*, PcanTimestamp*);
+using CAN_ReadFD_t       = PcanStatus(PCAN_CALL *)(PcanHandle, PcanMsgFD*, PcanTimestampFD*);
+using CAN_SetValue_t     = PcanStatus(PCAN_CALL *)(PcanHandle, uint8_t /*TPCANParameter*/, void* /*Buffer*/, uint32_t /*BufferLength*/);
+using CAN_GetValue_t     = PcanStatus(PCAN_CALL *)(PcanHandle, uint8_t /*TPCANParameter*/, void* /*Buffer*/, uint32_t /*BufferLength*/);
+using CAN_FilterMessages_t = PcanStatus(PCAN_CALL *)(PcanHandle, uint32_t /*FromID*/, uint32_t /*ToID*/, uint8_t /*TPCANMode*/);
 
 class PcanChannel final : public ICanChannel {
 public:
-    static PcanChannel* instance();
+    /// section: bitrate / bitrate_fd'nin okunacağı config bölümü
+    explicit PcanChannel(std::string section = "can") : section_(std::move(section)) {}
+    ~PcanChannel() override;
 
     bool open(std::string_view ifname, bool fd_mode = false) override;
     bool read(Frame& out) override;
     void close() override;
 
+    /// PCAN_RECEIVE_EVENT bekler (en fazla 100 ms), sonra kuyruğu
+    /// QRCVEMPTY'ye ya da out dolana kadar boşaltır.
+    bool readBatch(std::span<Frame> out, std::size_t& count) override;
+    /// Yalnızca kuyruğu boşaltır, olay beklemez (epoll thread'i bloklanmaz)
+    bool drain(std::span<Frame> out, std::size_t& count) override;
+    /// Kuyruk/denetleyici taşma olayı sayısı (PCAN kaybolan frame adedini bildirmez)
+    uint64_t droppedFrames() const override { return dropped_; }
+    /// Linux'ta alım olayı fd'si (epoll ile beklenebilir); Windows'ta -1
+    int nativeHandle() const override { return eventFd_; }
+
+    /// Adaptör tip başına (11/29 bit) tek kod/maske çifti tutar: tüm filtreleri
+    /// kapsayan en dar çift yüklenir. CAN_SetValue yoksa CAN_FilterMessages ile
+    /// en dar ID aralığına düşülür. Ters filtreler desteklenmez.
+    bool setFilters(std::span<const CanFilter> filters) override;
+
 private:
-    PcanChannel() = default;
     bool loadLibrary();
     bool parseChannel(std::string_view ifname, PcanHandle &outHandle);
+    /// Tek frame okur; PCAN_ERROR_OK dışındaki durum olduğu gibi döner
+    PcanStatus readOne(Frame& out, bool& valid);
+    /// out dolana ya da QRCVEMPTY'ye kadar okur; count'a ekler
+    void drainQueue(std::span<Frame> out, std::size_t& count);
+    bool setupReceiveEvent();
+    bool waitReceive(int timeoutMs);
+    void reportStatus(PcanStatus st);
+    std::chrono::microseconds toSteady(uint64_t hwUs, int64_t hostUs);
+
     bool opened_ {false};
+    bool fdMode_ {false};
+    std::string section_;
     #if defined(_WIN32)
         HMODULE libHandle_ {nullptr};
     #else
         void* libHandle_ {nullptr};
     #endif
     PcanHandle handle_ {0};
+    int eventFd_ {-1};                       ///< Linux: PCAN_RECEIVE_EVENT fd'si (sürücüye ait, kapatılmaz)
+    #if defined(_WIN32)
+        HANDLE event_ {nullptr};
+    #endif
+    uint64_t dropped_ {0};
+
+    // Donanım saati → steady_clock: en küçük (host - hw) farkı (gecikmesi en az
+    // olan frame) ofset kabul edilir; saat kayması için yavaşça yukarı izlenir
+    bool    synced_ {false};
+    int64_t offsetUs_ {0};
+    int64_t lastSyncHostUs_ {0};
+
+    // Hata günlüğü hız sınırı
+    std::chrono::steady_clock::time_point lastErrorLog_ {};
+    uint32_t suppressedErrors_ {0};
     // Fonksiyon pointer'ları
     CAN_Initialize_t   fpInitialize_   {nullptr};
+    CAN_InitializeFD_t fpInitializeFD_ {nullptr};
     CAN_Uninitialize_t fpUninitialize_ {nullptr};
     CAN_Read_t         fpRead_         {nullptr};
+    CAN_ReadFD_t       fpReadFD_       {nullptr}; // eski kütüphanelerde olmayabilir
+    CAN_SetValue_t     fpSetValue_     {nullptr};
+    CAN_GetValue_t     fpGetValue_     {nullptr};
+    CAN_FilterMessages_t fpFilterMessages_ {nullptr};
 };
 
 }
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "bus/can_channel.hpp"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace canmqtt::bus {
+
+/// Kayıt dosyasını canlı hat gibi besleyen backend (backend=replay).
+///
+/// interface: dosya yolu ya da dizin (dizindeki .vcap/.log/.asc dosyaları ad
+/// sırasıyla). Biçim uzantıdan/içerikten anlaşılır: candump -l (.log),
+/// Vector ASC (.asc), ham kayıt (.vcap, util/capture_format.hpp).
+/// Ayarlar kanal bölümünden, yoksa [replay]'den okunur:
+///   speed  = 1 orijinal zamanlama, 2 iki kat hızlı, 0 beklemeden (azami hız)
+///   loop   = 1 ise dosya(lar) bitince baştan
+///   source = yalnızca bu arayüz/kanal adının frame'leri (boş: hepsi)
+class ReplayChannel final : public ICanChannel {
+public:
+    explicit ReplayChannel(std::string section = "can");
+    ~ReplayChannel() override;
+
+    bool open(std::string_view ifname, bool fd_mode = false) override;
+    bool read(Frame& out) override;
+    bool readBatch(std::span<Frame> out, std::size_t& count) override;
+    bool setFilters(std::span<const CanFilter> filters) override;
+    void close() override;
+
+    class Reader;   ///< biçime özgü ardışık okuyucu (kaynak dosyada)
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    bool openFile(std::size_t index);
+    bool next(Frame& out, int64_t& fileUs);
+    /// Okuyucuyu bırakır ve özeti loglar; sonraki okumalar zaman aşımıyla boş döner
+    void finish();
+    bool accepted(const Frame& f) const;
+
+    std::string section_;
+    std::vector<std::string> files_;
+    std::size_t fileIndex_ {0};
+    std::unique_ptr<Reader> reader_;
+    std::vector<CanFilter> filters_;
+
+    double speed_ {1.0};
+    bool   loop_ {false};
+    std::string source_;
+
+    // Zamanlama: hedef = base_ + (fileUs - fileBaseUs_) / speed_
+    Clock::time_point base_ {};
+    int64_t fileBaseUs_ {0};
+    bool    haveBase_ {false};
+
+    bool   pending_ {false};          ///< zamanı gelmemiş frame bekletiliyor
+    Frame  pendingFrame_ {};
+    int64_t pendingUs_ {0};
+
+    bool     finished_ {false};
+    uint64_t replayed_ {0};
+    uint64_t passFrames_ {0};         ///< döngünün bu turunda kabul edilen frame
+    Clock::time_point started_ {};
+};
+
+} // namespace canmqtt::bus
@@ -10,9 +10,9 @@
 #include <sys/socket.h>
 #include <unistd.h>
 #endif
+#include <array>
 #include <cstring>
 #include <functional>
-#include <absl/base/no_destructor.h>  
 
 namespace canmqtt::bus {
 
@@ -23,17 +23,35 @@ class SocketCanChannel final: public ICanChannel {
         SocketCanChannel(SocketCanChannel&&) noexcept            = default; // movable
         SocketCanChannel& operator=(SocketCanChannel&&) noexcept = default; // movable
 
+        SocketCanChannel() = default;
         ~SocketCanChannel() override { close(); }
 
-        static SocketCanChannel& getInstance();
         bool open(std::string_view ifname, bool fd_mode = false) override;
         bool read(Frame& out) override;
+        bool readBatch(std::span<Frame> out, std::size_t& count) override;
+        uint64_t droppedFrames() const override { return dropped_; }
+        int nativeHandle() const override { return fd_; }
+        bool setFilters(std::span<const CanFilter> filters) override;
         void close() override;
         void startProcessingData();         
+
+        static constexpr std::size_t kMaxBatch = kRxBatchSize;   ///< tek recvmmsg çağrısındaki üst sınır
     private:
-        friend class absl::NoDestructor<SocketCanChannel>;
-        SocketCanChannel()  = default;
     int fd_ = -1; // yalnızca Linux'ta anlamlı
+    bool fdMode_ = false;        ///< CAN_RAW_FD_FRAMES etkin mi
+    uint64_t dropped_ = 0;       ///< SO_RXQ_OVFL ile raporlanan kümülatif kayıp
+#ifdef __linux__
+    // recvmmsg tamponları: her okuma için yeniden kullanılır (heap yok)
+    struct RxSlot {
+        canfd_frame frame;           ///< klasik frame'ler de aynı düzende gelir (CAN_MTU)
+        alignas(cmsghdr) char control[CMSG_SPACE(3 * sizeof(timespec)) +
+                                      CMSG_SPACE(sizeof(timespec)) +
+                                      CMSG_SPACE(sizeof(uint32_t))];
+    };
+    std::array<RxSlot, kMaxBatch>  rx_{};
+    std::array<iovec, kMaxBatch>   iov_{};
+    std::array<mmsghdr, kMaxBatch> msgs_{};
+#endif
     };
 }
 
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <charconv>
+#include <iostream>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <absl/base/no_destructor.h>  
@@ -10,27 +13,60 @@ class ConfigLoader {
  public:
   ConfigLoader(const ConfigLoader&) = delete; // non-copyable
   ConfigLoader& operator=(const ConfigLoader&) = delete; // non-copyable
-  ConfigLoader(ConfigLoader&&) = default; // movable
-  ConfigLoader& operator=(ConfigLoader&&) = default; // movable
   ~ConfigLoader() = default;
   
   static ConfigLoader& getInstance();
 
+  /// Dosya önce ayrı tabloya okunur, sonra tek adımda değiştirilir: eşzamanlı
+  /// Get() çağrıları eski ya da yeni tabloyu görür, yarım okunmuşu görmez
   bool Load(const std::string& path);
+  /// Son başarılı Load() yolunu yeniden okur (hot reload)
+  bool Reload();
+  std::string Path() const;
 
+  /// Thread-safe (okuma kilidi); hat içinde değil kurulumda kullanılır
   std::string Get(const std::string& section,
                          const std::string& key,
                          const std::string& def) const ;
+
+  /// Sayısal değer (T: tamsayı ya da double). Anahtar yok ya da boşsa def;
+  /// ayrıştırılamayan ya da T'ye sığmayan değer loglanır ve def döner
+  template <class T>
+  T GetNumber(const std::string& section, const std::string& key, T def) const;
+
+  /// Bölümün tüm anahtar=değer çiftlerinin kopyası (okuma kilidi); bölüm yoksa boş.
+  /// Anahtarları önceden bilinmeyen bölümler için ([publish] gibi)
+  std::unordered_map<std::string, std::string> Section(const std::string& section) const;
     
-  const std::unordered_map<std::string,std::unordered_map<std::string, std::string>>&
-  DebugAll() const { return table_; }
+  std::unordered_map<std::string,std::unordered_map<std::string, std::string>>
+  DebugAll() const { std::shared_lock lock(mutex_); return table_; }
 
  private:
   ConfigLoader() = default;
+  mutable std::shared_mutex mutex_;
+  std::string path_;
   std::unordered_map<std::string, std::unordered_map<std::string, std::string>> table_;
   friend class absl::NoDestructor<ConfigLoader>;
 
 
 };
 
+template <class T>
+T ConfigLoader::GetNumber(const std::string& section, const std::string& key, T def) const {
+  const std::string raw = Get(section, key, "");
+  const auto first = raw.find_first_not_of(" \t\r");
+  if (first == std::string::npos) return def;
+  const char* begin = raw.data() + first;
+  const char* end = raw.data() + raw.find_last_not_of(" \t\r") + 1;
+
+  T value {};
+  const auto [ptr, ec] = std::from_chars(begin, end, value);
+  if (ec != std::errc{} || ptr != end) {
+    std::cerr << "[ConfigLoader] [" << section << "] " << key << "=" << raw
+              << " geçersiz, varsayılan " << def << " kullanılıyor\n";
+    return def;
+  }
+  return value;
+}
+
 } 
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+#include "dbc/dbc_database.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace canmqtt::dbc {
+
+/// Derlenmiş DBC'nin (mesaj kayıtları + DecodePlan sütunları) ikili önbelleği.
+///
+/// Düz, 8 bayt hizalı bölümlerden oluşur; dosya mmap ile açılıp sütunlar
+/// doğrudan kopyalanır, dbcppp ayrıştırıcısı hiç çalışmaz. Başlıktaki
+/// fingerprint DBC içeriğinin FNV-1a 64 özetidir: DBC değişince önbellek
+/// reddedilir ve tam ayrıştırmadan sonra yeniden yazılır. Yerel bayt sırası
+/// ve hizalamayla yazılır; başka mimaride üretilmiş dosya da reddedilir.
+class DbcCache {
+public:
+    static constexpr uint32_t kVersion = 1;
+
+    /// path fingerprint'e ait geçerli bir önbellekse messages/plan doldurulur
+    static bool read(const std::string& path, uint64_t fingerprint,
+                     std::vector<MessageInfo>& messages, DecodePlan& plan);
+
+    /// Geçici dosyaya yazıp rename eder: yarım dosya hiç görünmez
+    static bool write(const std::string& path, uint64_t fingerprint,
+                      const std::vector<MessageInfo>& messages, const DecodePlan& plan);
+};
+
+} // namespace canmqtt::dbc
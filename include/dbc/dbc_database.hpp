@@ -1,36 +1,155 @@
 #pragma once
 #include <dbcppp/Network.h>
+#include "dbc/decode_plan.hpp"
+#include "bus/can_filter.hpp"
+#include <atomic>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <map>
+#include <unordered_map>
 #include <vector>
+#include <span>
 #include <cstdint>
 #include <absl/base/no_destructor.h>  
 
 namespace canmqtt::dbc {
 
+/// load() sırasında derlenen mesaj kaydı
+struct MessageInfo {
+    uint32_t id {};                          ///< bayraksız 11-/29-bit ID
+    std::string name;
+    uint32_t size {};                        ///< DBC'deki payload boyu (bayt)
+    uint32_t first_signal {};                ///< DecodePlan içindeki ilk sinyal
+    uint32_t signal_count {};
+    int32_t  mux_signal {-1};                ///< mux switch sinyali (global indeks) ya da -1
+    bool     extended {false};               ///< 29-bit (DBC'de bit31 set ya da ID > 0x7FF)
+};
+
+/// resolve() sonucu; nullptr = DBC'de karşılığı yok
+using MessageHandle = const MessageInfo*;
+
+/// Yeniden kullanılabilir decode çıktısı: (global sinyal indeksi, değer) çiftleri.
+/// Kapasite bir kez maxSignalsPerMessage() kadar ayrılır; sonrası heap'e dokunmaz.
+class DecodedSignals {
+public:
+    DecodedSignals() = default;
+    explicit DecodedSignals(std::size_t capacity) { reserve(capacity); }
+
+    void reserve(std::size_t capacity) {
+        if (capacity > index_.size()) { index_.resize(capacity); value_.resize(capacity); }
+    }
+    std::size_t capacity() const { return index_.size(); }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    void clear() { size_ = 0; }
+
+    uint32_t index(std::size_t k) const { return index_[k]; }
+    double   value(std::size_t k) const { return value_[k]; }
+    const double* values() const { return value_.data(); }   ///< [0, size()) bitişik
+
+    /// keep(index, value) false dönen çiftleri sırayı koruyarak çıkarır
+    template <class Keep>
+    void retain(Keep keep) {
+        std::size_t n = 0;
+        for (std::size_t k = 0; k < size_; ++k)
+            if (keep(index_[k], value_[k])) { index_[n] = index_[k]; value_[n] = value_[k]; ++n; }
+        size_ = n;
+    }
+
+private:
+    friend class DbcDatabase;
+    std::vector<uint32_t> index_;
+    std::vector<double>   value_;
+    std::size_t size_ {0};
+};
+
 class DbcDatabase {
 public:
+    DbcDatabase() = default;
     ~DbcDatabase() = default;
     DbcDatabase(DbcDatabase&&) = default; // movable
     DbcDatabase& operator=(const DbcDatabase&) = delete; // non-copyable
     DbcDatabase& operator=(DbcDatabase&&) = default; // movable
 
-    bool load(const std::string& dbc_file);
+    /// cache_file verilirse önce derlenmiş önbellek (bkz. DbcCache) denenir;
+    /// yoksa ya da DBC değişmişse tam ayrıştırılıp önbellek yeniden yazılır
+    bool load(const std::string& dbc_file, const std::string& cache_file = {});
+
+    /// Ham ID'yi mesaja çözer (tam → SA’sız → PGN). Sonuçlar (bulunamayanlar
+    /// dahil) ID başına önbelleğe alınır; thread-safe ve kilitsizdir.
+    MessageHandle resolve(uint32_t id) const;
+
+    /// Mesajı out'a çözer; out kapasitesi yetiyorsa (bkz. maxSignalsPerMessage)
+    /// hiç heap ayırmaz. İsimler signalName() ile yalnızca serileştirirken çözülür.
+    bool decode(MessageHandle msg,
+                std::span<const uint8_t> data,
+                DecodedSignals& out) const;
 
     /// id’li mesajı çözüp (isim-değer) tablosu döndürür
     bool decode(uint32_t id,
-                const std::vector<uint8_t>& data,
+                std::span<const uint8_t> data,
+                std::map<std::string, double>& out) const;
+
+    /// resolve() ile bulunmuş mesajı çözer (tekrar arama yapmaz)
+    bool decode(MessageHandle msg,
+                std::span<const uint8_t> data,
                 std::map<std::string, double>& out) const;
 
+    /// decode()'un tersi: values[k] mesajın k. sinyalinin fiziksel değeri
+    /// (values.size() >= signal_count). out'un ilk msg->size baytı sıfırlanıp
+    /// doldurulur; trafik üreticisi (tools/vscan_gen) için.
+    bool encode(MessageHandle msg,
+                std::span<const double> values,
+                std::span<uint8_t> out) const;
+
     std::string getMessageNameById(uint32_t id) const;
 
+    /// resolve()'un eşleyebileceği tüm frame'leri kabul eden filtreler:
+    /// 11-bit mesajlar tam ID, 29-bit mesajlar PGN maskesiyle (öncelik/SA önemsiz).
+    /// exclude'a tam ID'si uyan mesajlar dışarıda kalır. j1939Tp ise ve DBC'de
+    /// 29-bit mesaj varsa TP.CM (PF 0xEC) ve TP.DT (PF 0xEB) her DA/SA için
+    /// eklenir: RTS/CTS oturumları DA'ya yönelik gelir, PGN maskesine uymaz.
+    /// Birleştirilmemiş liste döner; kanal sınırı için bus::CompactFilters() kullanılır.
+    std::vector<bus::CanFilter> acceptanceFilters(const std::vector<bus::CanFilter>& exclude = {},
+                                                  bool j1939Tp = false) const;
+
+    const std::vector<MessageInfo>& messages() const { return messages_; }
+    const DecodePlan& plan() const { return plan_; }
+
+    /// load() sırasında bir kez kaydedilen sinyal adı
+    std::string_view signalName(uint32_t index) const { return plan_.name(index); }
+    std::size_t signalCount() const { return plan_.size(); }
+    std::size_t maxSignalsPerMessage() const { return maxSignals_; }
+
+    /// DBC dosya içeriğinin FNV-1a 64 özeti (sinyal indekslerinin geçerli olduğu sürüm)
+    uint64_t fingerprint() const { return fingerprint_; }
+
+    /// [dbc] file ile yüklenen varsayılan veritabanı; kanal başına ayrı DBC
+    /// gerektiğinde DbcDatabase doğrudan oluşturulur (bkz. task::Capture)
     static DbcDatabase& getInstance();
 
 private:
-    DbcDatabase() = default;
-    friend class absl::NoDestructor<DbcDatabase>;
-    std::unique_ptr<dbcppp::INetwork> db_;
+
+    MessageHandle lookup(uint32_t id) const;
+    void compile();
+    void buildIndex();
+
+    std::unique_ptr<dbcppp::INetwork> db_;   ///< önbellekten yüklenince boş
+    std::vector<MessageInfo> messages_;
+    DecodePlan plan_;
+    std::size_t maxSignals_ {0};
+    uint64_t fingerprint_ {0};
+
+    // Üç eşleşme katmanı: anahtar → messages_ indeksi (DBC sırasında ilk gelen kazanır)
+    std::unordered_map<uint32_t, uint32_t> byId_;
+    std::unordered_map<uint32_t, uint32_t> byNoSa_;
+    std::unordered_map<uint32_t, uint32_t> byPgn_;
+
+    // Ham ID → sonuç önbelleği (direct-mapped). Girdi: bit63 geçerli,
+    // bit32-60 ID, bit0-31 mesaj indeksi (kNoMessage = bulunamadı).
+    static constexpr std::size_t kCacheBits = 12;
+    std::unique_ptr<std::atomic<uint64_t>[]> cache_;
 };
 
 } // namespace dbc
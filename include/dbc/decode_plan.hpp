@@ -0,0 +1,84 @@
+#pragma once
+#include <dbcppp/Network.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace canmqtt::dbc {
+
+/// DBC'nin tüm sinyalleri için düz, structure-of-arrays decode tablosu.
+/// Her mesajın sinyalleri [first, first+count) aralığında bitişiktir;
+/// decode sanal çağrı olmadan bu sütunlar üzerinde tek geçişte yapılır.
+/// Aynı sütunlar ters yönde (encode) trafik üretimi için de kullanılır.
+class DecodePlan {
+public:
+    enum Flags : uint8_t {
+        kBigEndian = 1u << 0,   ///< Motorola bayt sırası
+        kSigned    = 1u << 1,   ///< ikiye tümleyen işaret genişletme
+        kFloat     = 1u << 2,   ///< IEEE754 32-bit ham değer
+        kDouble    = 1u << 3,   ///< IEEE754 64-bit ham değer
+        kSlow      = 1u << 4,   ///< tek 64-bit yüklemeye sığmıyor, bit bit okunur
+        kMuxed     = 1u << 5,   ///< mux değerine bağlı (MuxValue)
+    };
+
+    void clear();
+    void reserve(std::size_t n);
+
+    /// Sinyali tabloya derler, global sinyal indeksini döndürür
+    uint32_t add(const dbcppp::ISignal& s);
+
+    std::size_t size() const { return factor_.size(); }
+    const std::string& name(uint32_t i) const { return name_[i]; }
+
+    /// Ham (ölçeklenmemiş) tam sayı değeri; mux switch karşılaştırması için
+    uint64_t extractRaw(uint32_t i, std::span<const uint8_t> data) const;
+
+    /// [first, first+count) sinyallerini çözer. mux >= 0 ise mux sinyali bir kez
+    /// okunur ve eşleşmeyen MuxValue sinyalleri atlanır. Sonuçlar out_idx/out_val
+    /// dizilerine yazılır (kapasite >= count), yazılan adet döner.
+    std::size_t evaluate(uint32_t first, uint32_t count, int32_t mux,
+                         std::span<const uint8_t> data,
+                         uint32_t* out_idx, double* out_val) const;
+
+    /// evaluate()'in tersi: values[k], first+k sinyalinin fiziksel değeri.
+    /// mux >= 0 ise switch değeri values'tan alınır ve ona ait olmayan
+    /// MuxValue sinyalleri yazılmaz. Alan dışındaki bitlere dokunulmaz.
+    void encode(uint32_t first, uint32_t count, int32_t mux,
+                const double* values, std::span<uint8_t> data) const;
+
+    /// Fiziksel değer → ham alan (ölçeğin tersi, yuvarlama, alan sınırına kırpma)
+    uint64_t toRaw(uint32_t i, double value) const;
+
+    /// Ham değeri payload'daki alana yazar
+    void insertRaw(uint32_t i, uint64_t raw, std::span<uint8_t> data) const;
+
+    /// Sinyalin fiziksel aralığı: DBC'deki [min, max], tanımsızsa (min >= max)
+    /// alanın ifade edebildiği aralık
+    std::pair<double, double> range(uint32_t i) const;
+
+private:
+    friend class DbcCache;   ///< sütunları olduğu gibi yazar/okur
+
+    double extractValue(uint32_t i, std::span<const uint8_t> data) const;
+    uint64_t extractSlow(uint32_t i, std::span<const uint8_t> data) const;
+    void insertSlow(uint32_t i, uint64_t raw, std::span<uint8_t> data) const;
+
+    // Sütunlar (indeks = global sinyal no)
+    std::vector<uint16_t> byte_off_;   ///< 64-bit yüklemenin başladığı bayt
+    std::vector<uint8_t>  shift_;      ///< yüklenen kelimede alanın LSB konumu
+    std::vector<uint8_t>  bit_size_;
+    std::vector<uint8_t>  flags_;
+    std::vector<uint16_t> start_bit_;  ///< DBC start bit (slow path)
+    std::vector<uint64_t> mask_;
+    std::vector<double>   factor_;
+    std::vector<double>   offset_;
+    std::vector<uint64_t> mux_value_;  ///< kMuxed sinyallerin switch değeri
+    std::vector<double>   minimum_;
+    std::vector<double>   maximum_;
+    std::vector<std::string> name_;
+};
+
+} // namespace canmqtt::dbc
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace canmqtt::mqtt
+{
+
+    class Publisher;
+
+    /// MQTT yük biçimi ([mqtt] format)
+    enum class PayloadFormat { Json, Binary };
+
+    /// Zaman penceresi ya da frame sayısı dolana kadar gelen kayıtları tek
+    /// MQTT mesajında toplar:
+    ///   JSON  : {"seq":N,"stream":s,"bus":"can0","count":k,"frames":[{...},{...}]}
+    ///   ikili : batch başlığı + k adet (u16 uzunluk, kayıt) — docs/binary_payload.md
+    /// seq her gönderimde bir artar; tüketici boşlukları (bus, stream) başına
+    /// buradan fark eder. Her hat işçisi kendi stream'ini yayınlar.
+    class FrameBatcher
+    {
+    public:
+        FrameBatcher(std::string busName,
+                     std::chrono::milliseconds window,
+                     std::size_t maxFrames,
+                     PayloadFormat format = PayloadFormat::Json,
+                     uint64_t fingerprint = 0,
+                     uint16_t stream = 0);
+
+        /// Yeni kaydın ekleneceği tampon (ayraç eklenmiş olarak)
+        std::string& next();
+        /// next() ile eklenen kaydı sayar; frame sınırı dolduysa true
+        bool commit(std::chrono::steady_clock::time_point now);
+        /// next() ile açılan kaydı (yazılamadıysa) geri alır
+        void discard();
+
+        /// Pencere süresi doldu mu (boş batch hiçbir zaman due değildir)
+        bool due(std::chrono::steady_clock::time_point now) const;
+
+        void flush(Publisher& pub, int qos);
+
+        /// İkili başlıktaki DBC fingerprint'i (DBC yeniden yüklenince; önce flush edilmeli)
+        void setFingerprint(uint64_t fingerprint) { fingerprint_ = fingerprint; }
+
+        const std::string& topic() const { return topic_; }
+        uint64_t sequence() const { return seq_; }
+
+    private:
+        std::string busName_;
+        std::string topic_;
+        std::chrono::milliseconds window_;
+        std::size_t maxFrames_;
+        PayloadFormat format_;
+        uint64_t fingerprint_;
+        uint16_t stream_;
+        std::size_t recordStart_ {0};               ///< kaydın (ikili: uzunluk öneki, JSON: ayraç) konumu
+
+        std::string body_;                          ///< virgülle ayrılmış kayıtlar
+        std::string out_;                           ///< gönderilen zarf
+        std::size_t count_ {0};
+        uint64_t seq_ {0};
+        std::chrono::steady_clock::time_point opened_ {};
+    };
+
+} // namespace canmqtt::mqtt
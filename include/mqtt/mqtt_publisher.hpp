@@ -1,12 +1,42 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <thread>
 #include <MQTTClient.h>
 #include <absl/base/no_destructor.h>  
+#include "util/bounded_queue.hpp"
 
 namespace canmqtt::mqtt
 {
 
+    /// Kuyruk dolduğunda ne yapılacağı
+    enum class OverflowPolicy { DropOldest, DropNewest, Block };
+
+    struct PublisherOptions
+    {
+        std::size_t    queue_size = 4096;                 ///< bekleyen mesaj üst sınırı (2'nin kuvvetine yuvarlanır)
+        int            inflight   = 10;                   ///< onay beklenen QoS>0 mesaj penceresi (en fazla kMaxInflight)
+        OverflowPolicy overflow   = OverflowPolicy::DropOldest;
+    };
+
+    /// Senkron paho istemcisinin reliable=0 iken izin verdiği en büyük in-flight pencere
+    inline constexpr int kMaxInflight = 10;
+
+    struct PublisherStats
+    {
+        uint64_t queued  {};
+        uint64_t sent    {};
+        uint64_t dropped {};
+        uint64_t failed  {};
+        uint64_t stalled {};   ///< PUBACK penceresi süre içinde açılmadı (mesaj yeniden denendi)
+    };
+
+    /// Publish() yalnızca kilitsiz kuyruğa yazar; broker ile konuşma ayrı
+    /// gönderici thread'de yapılır, böylece TCP takılmaları CAN okuyucuyu durdurmaz.
     class Publisher
     {
     public:
@@ -17,15 +47,50 @@ namespace canmqtt::mqtt
 
         bool Init(const std::string &uri,
                   const std::string &client_id,
-                  int keep_alive = 20);
+                  int keep_alive = 20,
+                  const PublisherOptions &opts = {});
         void Publish(const std::string &topic,
                      const std::string &payload,
-                     int qos = 0);
+                     int qos = 0,
+                     bool retained = false);
+        PublisherStats Stats() const;
         static Publisher& getInstance();
+        static OverflowPolicy ParsePolicy(const std::string &s);
     private:
         friend class absl::NoDestructor<Publisher>;
         Publisher() = default; 
+
+        struct OutMsg
+        {
+            std::string topic;
+            std::string payload;
+            int qos {0};
+            bool retained {false};
+        };
+
+        enum class SendResult { Sent, Failed, WindowFull };
+
+        void SenderLoop(std::stop_token st);
+        SendResult Send(OutMsg &m);
+        bool Reconnect();
+
+        static int  OnMessageArrived(void *ctx, char *topic, int len, MQTTClient_message *msg);
+        static void OnDeliveryComplete(void *ctx, MQTTClient_deliveryToken dt);
+        static void OnConnectionLost(void *ctx, char *cause);
+
         MQTTClient client_{nullptr};
+        MQTTClient_connectOptions connOpts_ = MQTTClient_connectOptions_initializer;
+        PublisherOptions opts_;
+        std::unique_ptr<util::BoundedQueue<OutMsg>> queue_;
+        std::jthread sender_;
+        std::chrono::steady_clock::time_point lastReconnect_ {};
+
+        std::atomic<int>      inflight_ {0};
+        std::atomic<uint64_t> queued_   {0};
+        std::atomic<uint64_t> sent_     {0};
+        std::atomic<uint64_t> dropped_  {0};
+        std::atomic<uint64_t> failed_   {0};
+        std::atomic<uint64_t> stalled_  {0};
     };
 
 } // namespace canmqtt::mqtt
@@ -0,0 +1,69 @@
+#pragma once
+
+// Paylaşılan bellek son-değer tablosunun sabit yerleşimi. Yazar (vsCANView)
+// ve okuyucu kütüphanesi (vscan_shm) bu dosyayı paylaşır; başka bağımlılığı
+// yoktur. Yerleşim değişirse kVersion artırılmalıdır.
+//
+//   [Header][SourceEntry × sourceCount][Slot × slotCount][isimler ("..\0")]
+//
+// Slot (kanal, DBC sinyali) başınadır; aynı mesajı gönderen farklı J1939
+// SA'ları aynı slotu günceller (canId son yazanı gösterir).
+
+#include <atomic>
+#include <cstdint>
+
+namespace canmqtt::shm {
+
+inline constexpr char kMagic[8] = {'V', 'C', 'A', 'N', 'L', 'V', 'T', '\0'};
+inline constexpr uint32_t kVersion = 1;
+inline constexpr const char* kDefaultName = "/vscan_latest";
+
+struct Header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t slotSize;
+    uint32_t slotCount;
+    uint32_t sourceCount;
+    uint32_t retired;              ///< 1: yazar yeni segmente geçti (DBC değişti/kapandı), yeniden açılmalı
+    uint64_t sourcesOffset;
+    uint64_t slotsOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+    int64_t  writerPid;
+    uint64_t reserved[3];
+};
+static_assert(sizeof(Header) == 96);
+
+struct SourceEntry {
+    uint32_t busOffset;            ///< isimler bölümünde
+    uint32_t firstSlot;
+    uint32_t slotCount;            ///< DBC'deki sinyal sayısı
+    uint32_t reserved;
+    uint64_t fingerprint;          ///< kanalın DBC'si (DbcDatabase::fingerprint)
+};
+static_assert(sizeof(SourceEntry) == 24);
+
+/// Tek yazar kilidi yoktur: seq çiftken CAS ile tek yapılır, alanlar yazılır,
+/// seq bir artırılıp yeniden çift olur. Okuyucu seq'i önce ve sonra okur;
+/// tekse ya da değiştiyse tekrar dener.
+struct alignas(64) Slot {
+    uint32_t seq;
+    uint32_t canId;                ///< son güncelleyen ham ID (bayraksız)
+    int64_t  ts;                   ///< µs, CLOCK_MONOTONIC (Frame::ts); 0: hiç güncellenmedi
+    double   value;
+    uint64_t updates;
+    uint32_t messageOffset;
+    uint32_t signalOffset;
+    uint32_t source;
+    uint32_t reserved[5];
+};
+static_assert(sizeof(Slot) == 64);
+
+// Süreçler arası: kilitsiz olmayan atomik paylaşılan bellekte çalışmaz
+static_assert(std::atomic_ref<uint32_t>::is_always_lock_free);
+static_assert(std::atomic_ref<int64_t>::is_always_lock_free);
+static_assert(std::atomic_ref<uint64_t>::is_always_lock_free);
+static_assert(std::atomic_ref<double>::is_always_lock_free);
+
+} // namespace canmqtt::shm
@@ -0,0 +1,77 @@
+#pragma once
+
+// vscan_shm: vsCANView'in paylaşılan bellek son-değer tablosunu okuyan küçük
+// kütüphane. Yalnızca bu başlığı ve latest_layout.hpp'yi gerektirir; MQTT,
+// DBC ya da vsCANView'in geri kalanına bağımlı değildir.
+//
+//   canmqtt::shm::LatestReader r;
+//   if (r.open()) {
+//       const uint32_t s = r.find("can0", "EEC1", "EngSpeed");
+//       canmqtt::shm::LatestReader::Value v;
+//       if (s != r.kNoSlot && r.read(s, v)) use(v.value);
+//   }
+//
+// Okuma kilitsizdir ve yazarı hiç bekletmez; slot indeksleri segment
+// boyunca sabittir. stale() true olunca (DBC değişti, yazar kapandı, çöktü
+// ya da yeniden başlayıp segmenti yeniledi) open() ile yeniden açılmalı ve
+// indeksler yeniden bulunmalıdır.
+
+#include "shm/latest_layout.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace canmqtt::shm {
+
+class LatestReader {
+public:
+    static constexpr uint32_t kNoSlot = ~uint32_t{0};
+
+    struct Value {
+        int64_t  ts;          ///< µs, CLOCK_MONOTONIC (std::chrono::steady_clock)
+        double   value;
+        uint32_t canId;       ///< son güncelleyen ham ID
+        uint64_t updates;     ///< segment açıldığından beri güncelleme sayısı
+    };
+
+    LatestReader() = default;
+    ~LatestReader();
+
+    LatestReader(const LatestReader&)            = delete;
+    LatestReader& operator=(const LatestReader&) = delete;
+
+    /// Açıksa önce kapatır; segment yoksa ya da sürümü uyuşmuyorsa false
+    bool open(const std::string& name = kDefaultName);
+    void close();
+    bool isOpen() const { return header_ != nullptr; }
+    /// Açık değil, segment emekli edildi, yazar süreci yok ya da ad artık başka
+    /// bir segmenti gösteriyor (çökme sonrası yeniden başlatma). İki sistem
+    /// çağrısı yapar: her okumada değil, tarama başına bir kez çağrılmalı
+    bool stale() const;
+
+    std::size_t size() const { return header_ ? header_->slotCount : 0; }
+    /// bus boşsa ilk eşleşen kanal; bulunamazsa kNoSlot
+    uint32_t find(std::string_view bus, std::string_view message, std::string_view signal) const;
+    std::string_view bus(uint32_t slot) const;
+    std::string_view message(uint32_t slot) const;
+    std::string_view signal(uint32_t slot) const;
+
+    /// Tutarlı bir kopya alır; slot hiç güncellenmediyse (ya da yazar yazarken öldüyse) false
+    bool read(uint32_t slot, Value& out) const;
+
+private:
+    std::string_view string(uint64_t offset) const;
+
+    std::string name_;
+    uint64_t dev_ {0};                                    ///< açılan segmentin kimliği (st_dev, st_ino)
+    uint64_t ino_ {0};
+    const void* base_ {nullptr};
+    std::size_t size_ {0};
+    const Header* header_ {nullptr};
+    const SourceEntry* sources_ {nullptr};
+    const Slot* slots_ {nullptr};
+};
+
+} // namespace canmqtt::shm
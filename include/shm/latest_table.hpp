@@ -0,0 +1,63 @@
+#pragma once
+
+#include "bus/can_channel.hpp"
+#include "dbc/dbc_database.hpp"
+#include "shm/latest_layout.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace canmqtt::shm {
+
+/// Yerel süreçler için POSIX paylaşılan bellekte son-değer tablosu (yazar).
+///
+/// Her kanalın DBC'sindeki her sinyale sabit bir slot düşer (bkz.
+/// latest_layout.hpp); slot indeksi kanalın ilk slotu + global sinyal
+/// indeksidir, güncelleme arama yapmaz. Slotlar slot başına seqlock ile
+/// kilitsiz güncellenir; aynı slota birden fazla işçi yazabilir (farklı
+/// SA'lar), kısa süreli yazma hakkı CAS ile alınır. Okuyucular yazarı hiçbir
+/// zaman bekletmez.
+///
+/// DBC değişince yerleşim değişir: yeni tablo aynı adla kurulur, eskisi
+/// retire() ile işaretlenir ve okuyucular yeniden açar.
+class LatestTable {
+public:
+    struct Source {
+        std::string bus;
+        const dbc::DbcDatabase* db;
+    };
+
+    /// Eski aynı adlı segment varsa kaldırılır; başarısızsa nullptr
+    static std::unique_ptr<LatestTable> create(const std::string& name, const std::vector<Source>& sources);
+    ~LatestTable();
+
+    LatestTable(const LatestTable&)            = delete;
+    LatestTable& operator=(const LatestTable&) = delete;
+
+    /// db kanalın tablodaki DBC'si değilse (değişim sürüyor) yazmaz
+    void update(std::size_t source, const dbc::DbcDatabase& db, const bus::Frame& frame,
+                dbc::MessageHandle msg, const dbc::DecodedSignals& sigs);
+
+    /// Okuyuculara segmentin bırakıldığını bildirir; ad artık yeni tablonundur
+    void retire();
+
+    uint64_t fingerprint(std::size_t source) const { return sources_[source].fingerprint; }
+    std::size_t sourceCount() const { return header_->sourceCount; }
+    const std::string& name() const { return name_; }
+
+private:
+    LatestTable() = default;
+
+    std::string name_;
+    void* base_ {nullptr};
+    std::size_t size_ {0};
+    Header* header_ {nullptr};
+    SourceEntry* sources_ {nullptr};
+    Slot* slots_ {nullptr};
+    bool retired_ {false};
+};
+
+} // namespace canmqtt::shm
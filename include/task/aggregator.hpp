@@ -0,0 +1,69 @@
+#pragma once
+
+#include "bus/can_channel.hpp"
+#include "dbc/dbc_database.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace canmqtt::task {
+
+/// Pencereli sinyal istatistiği: (kanal, ID) başına her sinyalin min, max,
+/// toplam, adet ve son değeri.
+///
+/// Değerler sinyal başına ayrı bitişik dizilerde (SoA) tutulur; (kanal, ID)
+/// ilk görüldüğünde signal_count'luk blok ayrılır, sonrası heap'e dokunmaz.
+/// Çoğullanmamış mesajda güncelleme dallanmasız bitişik bir döngüdür.
+///
+/// İki pencere dönüşümlü kullanılır: işçi etkin pencereye yazar, roll() ile
+/// kapatıp diğerine geçer; kapanan pencere bir sonraki roll()'a kadar
+/// değişmez ve başka bir thread'den (bkz. Pipeline::tick) okunabilir.
+/// add()/bind()/roll() yalnızca sahibi olan işçiden çağrılır.
+class Aggregator {
+public:
+    struct Block {
+        uint64_t key;                                     ///< (kanal << 32) | ham ID
+        uint32_t message;                                 ///< DbcDatabase::messages() indeksi
+        uint32_t base;                                    ///< dizilerdeki ilk sinyal
+    };
+
+    struct Window {
+        std::vector<Block> blocks;                        ///< kapanışta yerleşimin kopyası
+        std::vector<double> min, max, sum, last;
+        std::vector<uint32_t> count;                      ///< 0: pencerede hiç örnek yok
+        uint64_t fingerprint {0};                         ///< blokların ait olduğu DBC
+        std::chrono::microseconds start {}, end {};       ///< Frame::ts ile aynı saat
+        std::atomic<uint64_t> stamp {0};                  ///< kapandığı tick (0: kapanmadı)
+    };
+
+    Aggregator() = default;
+    Aggregator(const Aggregator&)            = delete;
+    Aggregator& operator=(const Aggregator&) = delete;
+
+    /// Yerleşimi db'ye göre sıfırlar; etkin penceredeki birikim atılır
+    void bind(const dbc::DbcDatabase& db, std::chrono::microseconds now);
+
+    void add(const bus::Frame& frame, dbc::MessageHandle msg, const dbc::DecodedSignals& sigs);
+
+    /// Etkin pencereyi tick damgasıyla kapatır, diğerini sıfırlayıp açar
+    void roll(uint64_t tick, std::chrono::microseconds now);
+
+    /// tick'te kapanmış pencere ya da nullptr (okuyucu thread)
+    const Window* closed(uint64_t tick) const;
+
+private:
+    static void reset(Window& w, std::size_t from);
+
+    const dbc::DbcDatabase* db_ {nullptr};
+    std::unordered_map<uint64_t, uint32_t> index_;        ///< anahtar → layout_ indeksi
+    std::vector<Block> layout_;
+    std::size_t slots_ {0};                               ///< bloklardaki toplam sinyal
+    std::array<Window, 2> windows_;
+    unsigned active_ {0};
+};
+
+} // namespace canmqtt::task
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "bus/can_channel.hpp"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <absl/base/no_destructor.h>
+
+namespace canmqtt::config { class ConfigLoader; }
+namespace canmqtt::dbc    { class DbcDatabase; }
+
+namespace canmqtt::task {
+
+/// Yakalanan tek arayüz: açık kanal ve ona bağlı DBC
+struct CaptureChannel {
+    std::string name;                          ///< MQTT konusundaki <bus>
+    std::string backend;
+    std::string iface;
+    std::unique_ptr<bus::ICanChannel> channel;
+    dbc::DbcDatabase* db {nullptr};            ///< aynı dosyayı kullanan kanallar paylaşır
+    std::string section;                       ///< config bölümü ([can] ya da [can.<ad>])
+    std::string dbcFile;
+    bool filtered {false};                     ///< kanala kabul filtresi yüklü
+};
+
+/// Config'teki kanal listesini kurar:
+///   [can] channels=can0,can1  → her ad için [can.<ad>] bölümü
+///   (backend, interface, fd, dbc, bitrate, bitrate_fd; boşsa [can]/[dbc] değerleri)
+/// channels boşsa [can] channel + [dbc] file ile tek kanal açılır.
+/// [filter] enable=1 ise her kanala DBC'sinden (ve include/exclude listelerinden)
+/// üretilen kabul filtreleri yüklenir; kanal bölümündeki filter, filter_include,
+/// filter_exclude anahtarları [filter] değerlerini ezer. Filtre kapatılırsa ya da
+/// üretilemezse (hot reload dahil) kanal yeniden her şeyi kabul eder.
+class Capture {
+public:
+    Capture(const Capture&)            = delete; // non-copyable
+    Capture& operator=(const Capture&) = delete; // non-copyable
+
+    static Capture& getInstance();
+
+    /// Kanalları oluşturur/açar ve DBC'leri yükler (aynı dosya bir kez yüklenir).
+    /// Açılamayan kanallar listeye alınmaz; en az bir kanal açıldıysa true.
+    bool setup(const config::ConfigLoader& cfg);
+
+    std::vector<CaptureChannel>& channels() { return channels_; }
+
+    /// Kanal bölümüne göre DBC yolu ([can.<ad>] dbc, yoksa [dbc] file)
+    static std::string dbcFileFor(const config::ConfigLoader& cfg, const std::string& section);
+    /// Hot reload: DBC'yi önbellek ayarlarıyla yeni bir örneğe yükler; olmazsa nullptr
+    std::unique_ptr<dbc::DbcDatabase> loadFresh(const std::string& file) const;
+    /// Kanalın DBC kaydını günceller ve kabul filtrelerini yeni DBC'den yeniden üretir
+    void updateDbc(const config::ConfigLoader& cfg, std::size_t index, dbc::DbcDatabase* db, const std::string& file);
+
+private:
+    Capture() = default;
+    friend class absl::NoDestructor<Capture>;
+
+    /// Yüklenemezse (dosya yok, ayrıştırılamadı) nullptr
+    dbc::DbcDatabase* loadDbc(const std::string& file, const std::string& defaultFile);
+    /// [dbc] cache=1 ise önbellek yolu: cache_dir/<ad>.vdbc, cache_dir boşsa DBC'nin yanı
+    std::string cachePath(const std::string& file) const;
+    void applyFilters(const config::ConfigLoader& cfg, const std::string& section, CaptureChannel& c);
+    /// Yüklü filtre varsa her şeyi kabul eden listeyle değiştirir
+    void acceptAll(CaptureChannel& c);
+
+    std::vector<CaptureChannel> channels_;
+    std::vector<std::unique_ptr<dbc::DbcDatabase>> owned_;
+    std::unordered_map<std::string, dbc::DbcDatabase*> byFile_;
+    bool dbcCache_ {true};
+    std::string dbcCacheDir_;
+};
+
+} // namespace canmqtt::task
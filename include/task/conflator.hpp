@@ -0,0 +1,81 @@
+#pragma once
+
+#include "bus/can_channel.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace canmqtt::task {
+
+/// (kanal, ID) → son frame tablosu: değişmeyen tekrarları çözmeden ayıklar.
+///
+/// Açık adresleme (doğrusal yoklama); yoklama yalnızca 8 baytlık anahtar
+/// dizisinde yapılır, frame'ler ayrı dizidedir. Kapasite kurulumda ayrılır,
+/// silme yoktur; tablo dolunca yeni ID'ler süzülmeden geçer. Thread-safe
+/// değildir: aynı (kanal, ID) hep aynı işçiye gittiği için her işçinin
+/// kendi örneği vardır.
+class Conflator {
+public:
+    /// heartbeat: değişmeyen değer en geç bu aralıkla yine yayınlanır (0: hiç)
+    Conflator(std::size_t capacity, std::chrono::milliseconds heartbeat);
+
+    Conflator(const Conflator&)            = delete;
+    Conflator& operator=(const Conflator&) = delete;
+
+    /// Değişiklik modu: yük/bayrak/uzunluk değiştiyse ya da heartbeat dolduysa
+    /// true (ve frame son değer olur). Tabloya sığmayan ID'ler için hep true.
+    bool changed(const bus::Frame& f);
+
+    /// Birleştirme modu: frame son değer olarak saklanır, drain()'de yayınlanır.
+    /// Tabloya sığmadıysa false: çağıran frame'i hemen yayınlamalı.
+    bool store(const bus::Frame& f);
+
+    /// Birleştirme modu: son drain'den bu yana değişen ya da heartbeat'i dolan
+    /// her kayıt için fn(frame)
+    template <class Fn>
+    void drain(std::chrono::microseconds now, Fn&& fn)
+    {
+        for (uint32_t i : used_) {
+            Slot& s = slots_[i];
+            if (!s.dirty && (heartbeat_.count() == 0 || now - s.sent < heartbeat_)) continue;
+            s.dirty = false;
+            s.sent = now;
+            fn(static_cast<const bus::Frame&>(s.last));
+        }
+    }
+
+    uint64_t suppressed() const { return suppressed_; }   ///< yayınlanmadan geçen tekrar/ara değer
+    uint64_t overflow() const { return overflow_; }       ///< tabloya sığmadığı için süzülmeyen frame
+    std::size_t size() const { return used_.size(); }
+
+private:
+    struct Slot {
+        bus::Frame last;
+        std::chrono::microseconds sent {};                ///< son yayın zamanı
+        bool dirty {false};                               ///< yayınlanmamış yeni değer var
+    };
+
+    static uint64_t keyOf(const bus::Frame& f)
+    {
+        // 0 boş girdi: geçerlilik biti anahtarı hiçbir zaman 0 yapmaz.
+        // Ham ID: standart 0x100 ile genişletilmiş 0x100 ayrı kayıtlardır
+        return (uint64_t{1} << 40) | (uint64_t{f.channel} << 32) | f.rawId();
+    }
+    static bool samePayload(const bus::Frame& a, const bus::Frame& b);
+    static void copy(bus::Frame& to, const bus::Frame& from);
+
+    /// Bulur ya da ekler; tablo doluysa nullptr. fresh: yeni eklendi
+    Slot* slot(const bus::Frame& f, bool& fresh);
+
+    std::vector<uint64_t> keys_;
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> used_;                          ///< drain() yalnızca dolu girdileri gezer
+    std::size_t mask_ {0};
+    std::size_t limit_ {0};                               ///< yük faktörü üst sınırı (%75)
+    std::chrono::microseconds heartbeat_;
+    uint64_t suppressed_ {0};
+    uint64_t overflow_ {0};
+};
+
+} // namespace canmqtt::task
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace canmqtt::config { class ConfigLoader; }
+namespace canmqtt::dbc    { class DbcDatabase; }
+
+namespace canmqtt::task {
+
+class Capture;
+class Pipeline;
+
+/// Config dosyasını ve kanalların DBC dosyalarını izler (Linux'ta inotify,
+/// diğer platformlarda saniyede bir değişiklik zamanı yoklaması).
+///
+/// Değişiklik debounce süresi kadar durulunca yeni DBC bu thread'de derlenir
+/// (önbellek dahil), Pipeline::replaceDbc ile kanala atomik olarak bağlanır;
+/// işçiler o ana kadar eski tablolarla çözmeye devam eder. synchronize()
+/// döndükten sonra eski sürüm bırakılır. Config'ten çalışırken uygulananlar:
+/// kanal başına dbc yolu, [console] echo, [pipeline] stats_interval_s;
+/// diğerleri (backend, MQTT, işçi sayısı...) yeniden başlatmada geçerli olur.
+class HotReload {
+public:
+    HotReload(config::ConfigLoader& cfg, Capture& capture, Pipeline& pipeline,
+              std::chrono::milliseconds debounce = std::chrono::milliseconds(300));
+    ~HotReload();
+
+    HotReload(const HotReload&)            = delete;
+    HotReload& operator=(const HotReload&) = delete;
+
+    void start();
+    void stop();
+
+    /// Değişen dosyaları uygular (izleme thread'i çağırır; testte elle de çağrılabilir)
+    void check();
+
+private:
+    void run(std::stop_token st);
+    std::vector<std::string> watchedFiles() const;
+    bool touched(const std::string& file);
+    void applyOptions();
+
+    config::ConfigLoader& cfg_;
+    Capture& capture_;
+    Pipeline& pipeline_;
+    std::chrono::milliseconds debounce_;
+
+    std::unordered_map<std::string, std::filesystem::file_time_type> stamps_;
+    /// Yeniden yüklenip kullanımda olan DBC'ler; başlangıçtakiler Capture'a aittir
+    std::vector<std::unique_ptr<dbc::DbcDatabase>> owned_;
+    std::jthread thread_;
+};
+
+} // namespace canmqtt::task
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <functional>
+
 namespace canmqtt::task {
 void StartPeriodic();  // sonsuz döngü (thread içinde)
+
+/// Periyodik thread'in her turunda çağrılır ([os] periodic_task_interval_ms);
+/// fn kısa sürmeli (tüm kayıtlar aynı thread'de sırayla çalışır)
+void OnPeriodicTick(std::function<void()> fn);
 }  // namespace task
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "bus/can_channel.hpp"
+#include "task/aggregator.hpp"
+#include "task/publish_filter.hpp"
+#include "task/signal_history.hpp"
+#include "util/bounded_queue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace canmqtt::dbc  { class DbcDatabase; }
+namespace canmqtt::mqtt { class Publisher; }
+namespace canmqtt::shm  { class LatestTable; }
+
+namespace canmqtt::task
+{
+
+    class Recorder;
+
+    /// Değişmeyen tekrarların ayıklanması ([dedup] mode)
+    enum class DedupMode
+    {
+        Off,        ///< her frame yayınlanır
+        Changes,    ///< yalnızca yükü değişen (ve heartbeat'i dolan) frame'ler
+        Conflate,   ///< ID başına son değer, tick() başına bir kez
+    };
+
+    struct PipelineOptions
+    {
+        std::size_t workers        = 2;      ///< çözümleme/serileştirme thread sayısı (0: çekirdek sayısı - 1)
+        std::size_t queue_size     = 4096;   ///< okuyucu → işçi halkası (işçi başına)
+        bool        echo           = false;
+        bool        pretty         = true;
+        bool        binary         = false;  ///< [mqtt] format=binary
+        int         qos            = 1;
+        int         batch_window_ms  = 0;
+        std::size_t batch_max_frames = 256;
+        std::chrono::seconds stats_interval {0}; ///< 0: istatistik basılmaz
+        bool        j1939_tp         = true;   ///< TP.CM/TP.DT parçalarını tek mesajda birleştir
+        std::size_t tp_max_sessions  = 256;    ///< işçi başına eşzamanlı oturum
+        std::chrono::milliseconds tp_timeout {750};
+        bool        tp_publish_frames = false; ///< TP parçalarını ayrıca tek tek de yayınla
+        DedupMode   dedup            = DedupMode::Off;
+        std::size_t dedup_table      = 4096;   ///< işçi başına izlenen (kanal, ID) sayısı
+        std::chrono::milliseconds heartbeat {1000}; ///< değişmeyen değer en geç bu aralıkla yine yayınlanır (0: hiç)
+        std::vector<PublishRuleSpec> publish_rules;  ///< [publish]: sinyal bazında deadband/aralık (boş: kapalı)
+        bool        aggregate        = false;  ///< tick() aralıklı pencerelerde sinyal min/max/ortalama/son/adet
+        bool        aggregate_raw    = true;   ///< toplarken frame'leri ayrıca tek tek de yayınla
+        SignalHistory* history       = nullptr; ///< çözülen değerler ayrıca geçmiş halkalarına (nullptr: kapalı)
+    };
+
+    struct PipelineStats
+    {
+        uint64_t read {};                      ///< okuyucuların aldığı toplam frame
+        uint64_t dropped {};                   ///< işçi halkası dolu olduğu için atılan
+        std::vector<uint64_t> readPerSource;   ///< kanal başına okunan frame
+        std::vector<uint64_t> processed;       ///< işçi başına işlenen frame
+        uint64_t tpCompleted {};               ///< birleştirilen J1939 TP mesajı
+        uint64_t tpFailed {};                  ///< zaman aşımı, iptal, havuz dolu, tutarsız
+        uint64_t suppressed {};                ///< dedup: yayınlanmayan tekrar/ara değer
+        uint64_t ruleSuppressed {};            ///< [publish] kurallarıyla hiç sinyali kalmayan frame
+        uint64_t unencodable {};               ///< ikili biçimin sınırlarını aştığı için yayınlanmayan
+    };
+
+    /// Hatta bağlı bir kanal; indeksi Frame::channel'a yazılır
+    struct PipelineSource
+    {
+        bus::ICanChannel* channel {nullptr};
+        std::string busName;
+        const dbc::DbcDatabase* db {nullptr};   ///< başlangıç DBC'si (bkz. Pipeline::replaceDbc)
+    };
+
+    /// Dinleyici hattı: okuyucu(lar) → (CAN ID'ye göre bölümlenmiş) işçiler → yayıncı.
+    ///
+    /// nativeHandle() veren kanalların hepsi (SocketCAN, Linux'ta PCAN olay
+    /// fd'si) tek bir epoll thread'inden okunur; tanıtıcısı olmayanlar kendi
+    /// thread'lerinde bloklayan readBatch() ile okunur. Okuyucular frame'e kanal indeksini
+    /// yazar ve kilitsiz halkalarla işçilere dağıtır; hiçbir zaman beklemez
+    /// (halka doluysa frame sayılarak atılır). Aynı (kanal, ID) hep aynı işçiye
+    /// gittiği için ID başına sıra korunur (J1939 TP frame'leri kaynak adrese
+    /// göre yönlendirilir ki bir oturumun parçaları aynı işçide birleşsin).
+    /// İşçiler çözer, serileştirir ve
+    /// Publisher kuyruğuna yazar; broker ile konuşan üçüncü aşama Publisher'ın
+    /// gönderici thread'idir.
+    ///
+    /// Kanalın DBC'si çalışırken değiştirilebilir (RCU): işçiler göstericiyi
+    /// frame başına tek atomik okumayla alır, kilit yoktur. Her boşaltma turu
+    /// sonunda işçi bir sessiz an (quiescent state) bildirir, beklerken çevrim
+    /// dışı sayılır; eski veritabanı ancak tüm işçiler değişimden sonraki bir
+    /// sessiz andan geçince serbest bırakılabilir (synchronize()).
+    class Pipeline
+    {
+    public:
+        /// recorder verilirse okunan her frame ayrıca ona bırakılır (bloklamaz)
+        Pipeline(std::vector<PipelineSource> sources,
+                 mqtt::Publisher& pub,
+                 const PipelineOptions& opts,
+                 Recorder* recorder = nullptr);
+        ~Pipeline();
+
+        Pipeline(const Pipeline&)            = delete;
+        Pipeline& operator=(const Pipeline&) = delete;
+
+        void start();
+        void stop();
+
+        PipelineStats stats() const;
+        std::size_t workerCount() const { return workers_.size(); }
+
+        const dbc::DbcDatabase* dbc(std::size_t source) const { return state_[source].db.load(); }
+        /// Kanalın DBC'sini değiştirir; ikili biçimde yeni şema önce yayınlanır.
+        /// Eski nesne synchronize() dönene kadar yaşamalıdır.
+        void replaceDbc(std::size_t source, const dbc::DbcDatabase& db);
+        /// Değişimden önce okunmuş DBC göstericilerinin hiçbir işçide kalmadığını
+        /// bekler (RCU grace period). Hat thread'lerinden çağrılmamalıdır.
+        /// Son-değer tablosu açıksa ve DBC değiştiyse tablo yeni yerleşimle
+        /// burada yeniden kurulur.
+        void synchronize();
+
+        /// Çözülen değerleri paylaşılan bellekte (shm::LatestTable) yerel
+        /// süreçlere açar; start()'tan önce çağrılmalıdır
+        bool exportLatest(const std::string& name);
+
+        /// Periyodik tur (StartPeriodic): birleştirme modunda işçilere son değerleri
+        /// yayınlatır; toplamada işçiler pencereyi kapatır ve bir önceki turda
+        /// kapanan pencere kanal başına tek mesajla (can/<bus>/agg) yayınlanır.
+        /// Tek bir thread'den çağrılmalıdır.
+        void tick();
+
+        /// Hot reload ile değişebilen ayarlar
+        void setEcho(bool echo) { echo_.store(echo, std::memory_order_relaxed); }
+        void setStatsInterval(std::chrono::seconds interval) { statsInterval_.store(interval.count(), std::memory_order_relaxed); }
+
+    private:
+        struct alignas(64) Worker
+        {
+            explicit Worker(std::size_t queueSize) : queue(queueSize) {}
+
+            util::BoundedQueue<bus::Frame> queue;
+            std::atomic<uint32_t> wake {0};     ///< okuyucu her teslimde artırır (atomic wait/notify)
+            std::atomic<uint64_t> processed {0};
+            std::atomic<uint64_t> dropped {0};
+            std::atomic<uint64_t> tpCompleted {0};
+            std::atomic<uint64_t> tpFailed {0};
+            std::atomic<uint64_t> suppressed {0};
+            std::atomic<uint64_t> ruleSuppressed {0};
+            std::atomic<uint64_t> unencodable {0};
+            std::atomic<uint64_t> quiescent {kOffline};   ///< son sessiz anda görülen dönem
+            std::vector<std::unique_ptr<Aggregator>> aggregators;   ///< kanal başına (toplama açıksa)
+            std::jthread thread;
+        };
+
+        /// Okuyucu tarafı kanal durumu (yalnızca o kanalı okuyan thread yazar)
+        struct alignas(64) SourceState
+        {
+            std::atomic<const dbc::DbcDatabase*> db {nullptr};   ///< işçiler okur, replaceDbc yazar
+            std::atomic<uint64_t> read {0};
+            uint64_t lastDropped {0};
+            bool firstFrameLogged {false};
+        };
+
+        static constexpr uint64_t kOffline = ~uint64_t{0};
+
+        void readerLoop(std::stop_token st, std::size_t source, bool statsOwner);
+        void pollLoop(std::stop_token st, std::vector<std::size_t> sources, bool statsOwner);
+        /// ready: tanıtıcı epoll'da hazır bildirildi, kanal beklemeden boşaltılır
+        bool readSource(std::size_t source, std::vector<bus::Frame>& batch, bool ready = false);
+        void workerLoop(std::stop_token st, Worker& w, std::size_t index);
+        std::size_t route(const bus::Frame& frame) const;
+        void wakeAll();
+        void publishAggregates(uint64_t tick);
+        std::unique_ptr<shm::LatestTable> buildLatest(const std::string& name) const;
+        void maybeLogStats();
+        void logStats(std::chrono::steady_clock::time_point now);
+
+        std::vector<PipelineSource> sources_;
+        std::unique_ptr<SourceState[]> state_;
+        mqtt::Publisher& pub_;
+        PipelineOptions opts_;
+        Recorder* recorder_;
+
+        std::vector<std::unique_ptr<Worker>> workers_;
+        std::vector<std::jthread> readers_;
+        std::mutex echoMutex_;                  ///< yalnızca konsol çıktısı (hata ayıklama) için
+        std::atomic<bool> echo_;
+        std::atomic<int64_t> statsInterval_;    ///< saniye
+        std::atomic<uint64_t> epoch_ {0};       ///< synchronize() her çağrıda artırır
+        std::atomic<uint64_t> tick_ {0};        ///< tick() nesli; işçiler değişince son değerleri yayınlar
+        std::mutex aggMutex_;                   ///< toplama yayını DBC'yi okurken synchronize() bekler
+        std::string aggBuf_;                    ///< yalnızca tick() thread'i
+        std::unique_ptr<shm::LatestTable> latestOwned_;       ///< synchronize() değiştirir
+        std::atomic<shm::LatestTable*> latest_ {nullptr};     ///< işçiler frame başına okur (RCU)
+
+        // logStats() yalnızca ilk okuyucu thread'den çağrılır
+        std::chrono::steady_clock::time_point lastStats_ {};
+        PipelineStats prevStats_ {};
+        uint64_t prevSent_ {0};
+        uint64_t prevRecDropped_ {0};
+    };
+
+} // namespace canmqtt::task
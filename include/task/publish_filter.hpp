@@ -0,0 +1,77 @@
+#pragma once
+
+#include "bus/can_channel.hpp"
+#include "dbc/dbc_database.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace canmqtt::task {
+
+/// Sinyal yayın kuralı. Yayınlanan son değere göre:
+///   max_interval dolduysa yayınla (heartbeat); min_interval dolmadıysa bastır;
+///   değilse |v - son| > deadband ve > son·deadbandPct/100 ise yayınla
+///   (ikisi de 0 ise herhangi bir değişiklik yeter).
+struct PublishRule {
+    double deadband {0.0};
+    double deadbandPct {0.0};
+    std::chrono::microseconds minInterval {0};
+    std::chrono::microseconds maxInterval {0};            ///< 0: heartbeat yok
+};
+
+/// Adla verilen kural: signal boşsa mesajın kuralı, message "*" ise varsayılan
+struct PublishRuleSpec {
+    std::string message;
+    std::string signal;
+    PublishRule rule;
+};
+
+/// "deadband=5, pct=1, min_ms=100, max_ms=1000" → rule; hatalı anahtar/değerde false
+bool ParsePublishRule(std::string_view text, PublishRule& rule);
+
+/// Sinyal bazında yayın süzgeci (deadband, en az/en çok aralık).
+///
+/// Kurallar DBC'ye bind() ile sinyal indeksine derlenir (sinyal > mesaj >
+/// varsayılan). Durum (son yayınlanan değer ve zamanı) (kanal, ID) başına
+/// ayrılan bitişik bloklarda tutulur: aynı PGN'i gönderen farklı SA'lar
+/// birbirini bastırmaz. Yeni ID ilk görüldüğünde blok ayrılır, sonrası
+/// heap'e dokunmaz. Thread-safe değildir: işçi ve kanal başına bir örnek.
+class PublishFilter {
+public:
+    explicit PublishFilter(std::vector<PublishRuleSpec> specs);
+
+    /// Kuralları db'nin sinyal indekslerine derler ve durumu sıfırlar;
+    /// report ise DBC'de karşılığı olmayan kurallar loglanır
+    void bind(const dbc::DbcDatabase& db, bool report = false);
+
+    /// Yayınlanmayacak sinyalleri sigs'ten çıkarır; hiçbiri kalmadıysa false
+    /// (frame yayınlanmaz). Kuralsız sinyaller ve çözülemeyen frame'ler geçer.
+    bool apply(const bus::Frame& frame, dbc::MessageHandle msg, dbc::DecodedSignals& sigs);
+
+    uint64_t suppressedSignals() const { return suppressedSignals_; }
+    uint64_t suppressedFrames() const { return suppressedFrames_; }
+
+private:
+    static constexpr uint16_t kNoRule = 0xFFFF;
+
+    bool pass(const PublishRule& r, uint32_t slot, double v, std::chrono::microseconds now);
+
+    std::vector<PublishRuleSpec> specs_;
+    const dbc::DbcDatabase* db_ {nullptr};
+    std::vector<PublishRule> rules_;
+    std::vector<uint16_t> ruleOf_;                        ///< global sinyal indeksi → rules_ (kNoRule: süzülmez)
+    std::vector<uint8_t> messageHasRule_;                 ///< mesaj indeksi → en az bir kurallı sinyal
+
+    std::unordered_map<uint64_t, uint32_t> blocks_;       ///< (kanal, ham ID) → durum bloğunun başı
+    std::vector<double> lastValue_;
+    std::vector<int64_t> lastUs_;                         ///< INT64_MIN: henüz yayınlanmadı
+
+    uint64_t suppressedSignals_ {0};
+    uint64_t suppressedFrames_ {0};
+};
+
+} // namespace canmqtt::task
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "bus/can_channel.hpp"
+#include "util/bounded_queue.hpp"
+#include "util/capture_format.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace canmqtt::task
+{
+
+    struct RecorderOptions
+    {
+        std::string dir          = "capture";
+        std::string prefix       = "vscan";
+        std::size_t segment_mb   = 64;       ///< segment dosyası boyu (açılışta ayrılır)
+        std::size_t max_segments = 0;        ///< > 0 ise en eski segmentler silinir
+        uint32_t    index_interval = 1024;   ///< kaç kayıtta bir indeks girdisi
+        std::size_t queue_size   = 65536;
+        std::chrono::milliseconds flush_interval {1000};  ///< msync(MS_ASYNC) + dataEnd güncelleme
+    };
+
+    /// Ham frame kaydedici (biçim: util/capture_format.hpp).
+    ///
+    /// Okuyucular frame'leri kendi halkasına bırakır (doluysa sayılarak atılır,
+    /// canlı MQTT hattı hiç beklemez). Yazıcı thread kayıtları önceden
+    /// ayrılmış, mmap'lenmiş segmente memcpy ile ekler; frame başına sistem
+    /// çağrısı yoktur, diske yazma flush_interval'de bir MS_ASYNC ile çekirdeğe
+    /// bırakılır. Segment dolunca indeks kapatılır ve yenisine geçilir.
+    class Recorder
+    {
+    public:
+        Recorder(const RecorderOptions& opts, std::vector<std::string> channelNames);
+        ~Recorder();
+
+        Recorder(const Recorder&)            = delete;
+        Recorder& operator=(const Recorder&) = delete;
+
+        /// Dizin oluşturur, ilk segmenti açar ve yazıcıyı başlatır
+        bool start();
+        void stop();
+
+        /// Okuyucu thread'lerden çağrılır; bloklamaz
+        void record(std::span<const bus::Frame> frames);
+
+        uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+        uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    private:
+        void writerLoop(std::stop_token st);
+        bool openSegment();
+        void closeSegment();
+        bool append(const bus::Frame& frame);
+        void closeIndexBlock();
+        void flush();
+        void pruneSegments();
+
+        RecorderOptions opts_;
+        std::vector<std::string> channelNames_;
+        util::BoundedQueue<bus::Frame> queue_;
+        std::jthread writer_;
+
+        // Yalnızca yazıcı thread kullanır
+        int      fd_ {-1};
+        uint8_t* map_ {nullptr};
+        std::size_t mapSize_ {0};
+        std::size_t offset_ {0};            ///< sonraki kaydın ofseti
+        std::size_t dataLimit_ {0};         ///< indeks alanının başı
+        std::size_t flushedUpTo_ {0};
+        uint32_t flushedIndex_ {0};
+        uint32_t sequence_ {0};
+        util::capture::IndexEntry block_ {};
+        std::vector<std::string> segments_; ///< açılış sırasıyla (max_segments için)
+
+        std::atomic<uint64_t> written_ {0};
+        std::atomic<uint64_t> dropped_ {0};
+    };
+
+} // namespace canmqtt::task
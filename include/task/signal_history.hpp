@@ -0,0 +1,123 @@
+#pragma once
+
+#include "bus/can_channel.hpp"
+#include "dbc/dbc_database.hpp"
+
+#include <absl/base/no_destructor.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace canmqtt::task {
+
+struct HistoryOptions {
+    std::size_t depth     = 4096;   ///< sinyal başına örnek (halka boyu)
+    std::size_t memory_mb = 64;     ///< tüm halkaların üst sınırı; dolunca yeni sinyal kaydedilmez
+};
+
+/// Süreç içi son sinyal geçmişi: sinyal başına sabit boyutlu (ts, değer) halkası.
+///
+/// Sütun düzeni: tüm zaman damgaları bir dizide, değerler ayrı dizide; seri
+/// s'nin halkası [s·depth, (s+1)·depth). Bellek init()'te bir kez ayrılır.
+/// Seri (bus, ID, sinyal adı) ilk görüldüğünde tahsis edilir; hot reload'da
+/// adı değişmeyen sinyaller geçmişini korur.
+///
+/// Her seriye tek bir işçi yazar ((kanal, ID) hep aynı işçiye gider). Okuma
+/// kilitsizdir (seqlock): yazar üzerine yazacağı indeksi önce duyurur,
+/// okuyucu kopyaladıktan sonra bakar ve bu arada ezilmiş olabilecek en eski
+/// örnekleri atar. Zaman damgaları seri içinde artan kabul edilir.
+class SignalHistory {
+public:
+    using Series = uint32_t;
+    static constexpr Series kNone = ~Series{0};
+
+    struct Sample {
+        std::chrono::microseconds ts;
+        double value;
+    };
+    struct Bucket {
+        std::chrono::microseconds start;                  ///< kovadaki ilk örneğin zamanı
+        double min, max, mean, last;
+        uint32_t count;
+    };
+    struct SeriesInfo {
+        Series id;
+        std::string bus;
+        uint32_t canId;                                   ///< ham ID (J1939'da SA dahil)
+        std::string message;
+        std::string signal;
+    };
+
+    static SignalHistory& getInstance();
+
+    /// Halkaları ayırır (bir kez); depth/bellek geçersizse false
+    bool init(const HistoryOptions& opts);
+    bool enabled() const { return capacity_ != 0; }
+    std::size_t depth() const { return depth_; }
+    std::size_t capacity() const { return capacity_; }
+
+    /// Yazar tarafı: seriyi bulur ya da tahsis eder; bellek dolduysa kNone
+    Series allocate(std::string_view bus, uint32_t canId, std::string_view message, std::string_view signal);
+    /// Yalnızca serinin yazarı çağırır
+    void append(Series s, std::chrono::microseconds ts, double value);
+
+    std::vector<SeriesInfo> list() const;
+    /// bus boşsa ilk eşleşen bus
+    Series find(std::string_view bus, std::string_view message, std::string_view signal) const;
+
+    /// [from, to] aralığındaki örnekler (eskiden yeniye); out'a yazılan sayı
+    std::size_t range(Series s, std::chrono::microseconds from, std::chrono::microseconds to,
+                      std::vector<Sample>& out) const;
+    /// [from, to] eşit genişlikte buckets kovaya bölünür; yalnızca dolu kovalar yazılır
+    std::size_t downsample(Series s, std::chrono::microseconds from, std::chrono::microseconds to,
+                           std::size_t buckets, std::vector<Bucket>& out) const;
+    bool latest(Series s, Sample& out) const;
+
+private:
+    friend class absl::NoDestructor<SignalHistory>;
+    SignalHistory() = default;
+
+    struct alignas(64) Ring {
+        std::atomic<uint64_t> head {0};                   ///< yazılmış örnek sayısı
+        std::atomic<uint64_t> claim {0};                  ///< yazılmakta olan (head + 1)
+    };
+
+    std::size_t depth_ {0};
+    std::size_t capacity_ {0};
+    std::unique_ptr<Ring[]> rings_;
+    std::unique_ptr<int64_t[]> ts_;                       ///< µs (Frame::ts)
+    std::unique_ptr<double[]> value_;
+
+    mutable std::mutex mutex_;                            ///< tahsis ve isim tablosu (sıcak yolda değil)
+    std::unordered_map<std::string, Series> byKey_;
+    std::vector<SeriesInfo> info_;
+    std::atomic<Series> count_ {0};
+};
+
+/// Bir kanalın çözülmüş sinyallerini SignalHistory'ye yazar. (kanal, ID)
+/// başına sinyal → seri eşlemesi ilk görüşte kurulur; sonrası kilitsizdir.
+/// İşçi ve kanal başına bir örnek.
+class HistoryWriter {
+public:
+    HistoryWriter(SignalHistory& history, std::string bus);
+
+    /// DBC değişince eşlemeyi sıfırlar (seriler isimle yeniden bulunur)
+    void bind(const dbc::DbcDatabase& db);
+    void add(const bus::Frame& frame, dbc::MessageHandle msg, const dbc::DecodedSignals& sigs);
+
+private:
+    SignalHistory& history_;
+    std::string bus_;
+    const dbc::DbcDatabase* db_ {nullptr};
+    std::unordered_map<uint64_t, uint32_t> blocks_;       ///< ham ID → series_ içindeki blok
+    std::vector<SignalHistory::Series> series_;
+};
+
+} // namespace canmqtt::task
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "bus/can_channel.hpp"
+#include "dbc/dbc_database.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace canmqtt::util {
+
+/// Sıkışık ikili MQTT yükü (ayrıntılar: docs/binary_payload.md).
+/// Sinyaller isim yerine global indeksle taşınır; indekslerin anlamı
+/// başlıktaki DBC parmak izine bağlıdır ve can/<bus>/schema konusunda
+/// (retained) yayınlanan şemadan çözülür.
+namespace binary {
+    inline constexpr uint8_t  kMagic0      = 'V';
+    inline constexpr uint8_t  kMagic1      = 'C';
+    inline constexpr uint8_t  kVersion     = 2;
+    inline constexpr uint8_t  kKindFrame   = 1;
+    inline constexpr uint8_t  kKindBatch   = 2;
+    inline constexpr uint16_t kNoMessage   = 0xFFFF;
+    inline constexpr uint16_t kValueF64    = 0x8000;   ///< sinyal indeksinde: değer f64
+    inline constexpr uint8_t  kFlagTp      = 0x40;     ///< bus::Frame::kTp: len=0, ardından u16 uzunluk
+    static_assert(kFlagTp == bus::Frame::kTp);
+    inline constexpr std::size_t kHeaderSize = 8;
+    inline constexpr std::size_t kBatchHeaderSize = kHeaderSize + 8;
+    // Biçim sınırları: bunları aşan kayıt maskelenmez, hiç yazılmaz
+    inline constexpr uint32_t    kMaxSignalIndex = 0x7FFF;
+    inline constexpr std::size_t kMaxSignals     = 0xFF;     ///< kayıt başına
+    inline constexpr std::size_t kMaxRecordSize  = 0xFFFF;   ///< batch'teki u16 uzunluk öneki
+    inline constexpr std::size_t kMaxBatchFrames = 0xFFFF;   ///< batch başlığındaki u16 sayı
+
+    void putU16(std::string& out, uint16_t v);
+    void putU32(std::string& out, uint32_t v);
+    void putU64(std::string& out, uint64_t v);
+    void writeU16(std::string& out, std::size_t at, uint16_t v);
+
+    /// 8 baytlık başlık: magic, sürüm, tür, parmak izinin alt 32 biti
+    void putHeader(std::string& out, uint8_t kind, uint64_t fingerprint);
+}
+
+/// Kayıt biçime sığmazsa (sinyal indeksi > kMaxSignalIndex, kMaxSignals'tan
+/// fazla sinyal, kMaxRecordSize'tan uzun kayıt ya da 0xFFFF'ten fazla mesaj)
+/// append() hiçbir şey eklemez ve false döner, serialize() boş tampon döner.
+/// Reddedilen kayıtlar sayılır; ilki nedeniyle loglanır.
+class BinaryFrameSerializer {
+public:
+    BinaryFrameSerializer();
+
+    /// Başlık + tek kayıt; bir sonraki serialize() çağrısına kadar geçerli
+    const std::string& serialize(const bus::Frame& frame,
+                                 std::string_view busName,
+                                 const dbc::DbcDatabase& db,
+                                 dbc::MessageHandle msg,
+                                 const dbc::DecodedSignals& sigs);
+
+    /// Başlıksız kaydı dış tampona ekler (toplu gönderim için)
+    bool append(std::string& out,
+                const bus::Frame& frame,
+                std::string_view busName,
+                const dbc::DbcDatabase& db,
+                dbc::MessageHandle msg,
+                const dbc::DecodedSignals& sigs);
+
+    /// Payload'ı frame dışında olan kayıtlar (J1939 TP); bkz. FrameSerializer
+    const std::string& serialize(const bus::Frame& frame,
+                                 std::span<const uint8_t> payload,
+                                 std::string_view busName,
+                                 const dbc::DbcDatabase& db,
+                                 dbc::MessageHandle msg,
+                                 const dbc::DecodedSignals& sigs);
+
+    bool append(std::string& out,
+                const bus::Frame& frame,
+                std::span<const uint8_t> payload,
+                std::string_view busName,
+                const dbc::DbcDatabase& db,
+                dbc::MessageHandle msg,
+                const dbc::DecodedSignals& sigs);
+
+    /// Biçime sığmadığı için yazılmayan kayıt sayısı
+    uint64_t rejected() const { return rejected_; }
+
+private:
+    bool reject(const bus::Frame& frame, const char* reason);
+
+    std::string buf_;
+    uint64_t rejected_ {0};
+};
+
+/// can/<bus>/schema için JSON: parmak izi, mesaj ve sinyal adları (indeks sırasıyla)
+std::string BuildSchemaJson(const dbc::DbcDatabase& db);
+
+} // namespace canmqtt::util
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace canmqtt::util {
+
+/// Sabit kapasiteli, kilitsiz MPMC kuyruk (Vyukov). Hücreler bir kez ayrılır;
+/// tryPush/tryPop yerinde doldurma/boşaltma ile slottaki nesneyi yeniden
+/// kullanır (örn. std::string kapasitesi korunur, heap'e dokunulmaz).
+template <class T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(std::size_t capacity)
+        : mask_(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1),
+          cells_(std::make_unique<Cell[]>(mask_ + 1))
+    {
+        for (std::size_t i = 0; i <= mask_; ++i)
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedQueue(const BoundedQueue&)            = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+    /// Yaklaşık doluluk (istatistik için)
+    std::size_t sizeApprox() const {
+        const std::size_t t = tail_.load(std::memory_order_relaxed);
+        const std::size_t h = head_.load(std::memory_order_relaxed);
+        return t >= h ? t - h : 0;
+    }
+
+    /// fill(T&) boş slotu doldurur; kuyruk doluysa false
+    template <class Fn> requires std::invocable<Fn&, T&>
+    bool tryPush(Fn&& fill) {
+        Cell* c;
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            c = &cells_[pos & mask_];
+            const std::size_t seq = c->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        fill(c->value);
+        c->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// take(T&) dolu slotu tüketir; kuyruk boşsa false
+    template <class Fn> requires std::invocable<Fn&, T&>
+    bool tryPop(Fn&& take) {
+        Cell* c;
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            c = &cells_[pos & mask_];
+            const std::size_t seq = c->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+        take(c->value);
+        c->seq.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPush(const T& v) { return tryPush([&](T& slot) { slot = v; }); }
+    bool tryPop(T& v)        { return tryPop([&](T& slot) { v = std::move(slot); }); }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<std::size_t> seq {0};
+        T value {};
+    };
+
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<std::size_t> head_ {0};
+    alignas(64) std::atomic<std::size_t> tail_ {0};
+};
+
+} // namespace canmqtt::util
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace canmqtt::util {
+
+/// Ham frame kayıt dosyası (.vcap) düzeni; kaydedici ve replay ortak kullanır
+/// (ayrıntılar: docs/capture_format.md). Tüm alanlar little-endian.
+///
+///   [0, kDataOffset)          FileHeader + NUL ayrılmış kanal adları
+///   [kDataOffset, dataEnd)    kayıtlar (RecordHeader + payload, 8 bayta hizalı)
+///   [indexOffset, ...)        indexCapacity adet IndexEntry (segment sonunda)
+///
+/// Segment dosyası açılışta tam boyutuyla ayrılır; yazıcı dataEnd'i periyodik
+/// günceller, dataEnd sonrası (çökme anında yazılmakta olan) veri geçersizdir.
+namespace capture {
+    inline constexpr char        kMagic[8]     = {'V', 'C', 'A', 'N', 'C', 'A', 'P', '\0'};
+    inline constexpr uint16_t    kVersion      = 1;
+    inline constexpr std::size_t kDataOffset   = 4096;
+    inline constexpr std::size_t kAlign        = 8;
+    inline constexpr uint32_t    kRawEff       = 0x80000000u;   ///< rawId bit31: 29-bit frame
+
+    struct FileHeader {
+        char     magic[8];
+        uint16_t version;
+        uint16_t headerSize;         ///< sizeof(FileHeader)
+        uint32_t indexInterval;      ///< kaç kayıtta bir IndexEntry
+        uint64_t segmentSize;        ///< dosya boyu (önceden ayrılmış)
+        int64_t  wallStartUs;        ///< açılıştaki system_clock (epoch µs)
+        int64_t  steadyStartUs;      ///< aynı andaki steady_clock: wall = ts - steadyStart + wallStart
+        uint64_t dataEnd;            ///< geçerli kayıtların sonu (dosya ofseti)
+        uint64_t recordCount;
+        uint64_t indexOffset;
+        uint32_t indexCapacity;
+        uint32_t indexCount;         ///< tamamlanmış IndexEntry sayısı
+        uint32_t sequence;           ///< segment sıra numarası
+        uint32_t channelCount;       ///< başlığın ardındaki kanal adı sayısı
+        uint8_t  reserved[48];
+    };
+    static_assert(sizeof(FileHeader) == 128);
+
+    /// Her kaydın başı; ardından len bayt payload, kAlign'a tamamlanır
+    struct RecordHeader {
+        int64_t  tsUs;               ///< steady_clock µs (Frame::ts)
+        uint32_t rawId;              ///< 29-bit ise bit31 set
+        uint8_t  channel;            ///< FileHeader ardındaki ad listesinde indeks
+        uint8_t  flags;              ///< bus::Frame::Flags
+        uint8_t  len;
+        uint8_t  reserved;
+    };
+    static_assert(sizeof(RecordHeader) == 16);
+
+    /// indexInterval kayıtlık bloğun özeti: zaman aralığı, ilk kaydın ofseti
+    /// ve bloktaki rawId'lerin 256 bitlik Bloom filtresi
+    struct IndexEntry {
+        int64_t  firstTsUs;
+        int64_t  lastTsUs;
+        uint64_t offset;
+        uint32_t count;
+        uint32_t reserved;
+        uint64_t idBloom[4];
+    };
+    static_assert(sizeof(IndexEntry) == 64);
+    static_assert(std::is_trivially_copyable_v<FileHeader> &&
+                  std::is_trivially_copyable_v<RecordHeader> &&
+                  std::is_trivially_copyable_v<IndexEntry>);
+
+    constexpr std::size_t recordSize(uint8_t len)
+    {
+        return (sizeof(RecordHeader) + len + kAlign - 1) & ~(kAlign - 1);
+    }
+
+    /// İki bağımsız karışımla iki bit: blok başına ~1000 farklı ID'ye kadar işe yarar
+    constexpr void bloomAdd(uint64_t (&bloom)[4], uint32_t rawId)
+    {
+        const uint32_t h1 = rawId * 0x9E3779B1u;
+        const uint32_t h2 = (rawId ^ (rawId >> 15)) * 0x85EBCA77u;
+        bloom[(h1 >> 30) & 3] |= uint64_t{1} << ((h1 >> 24) & 63);
+        bloom[(h2 >> 30) & 3] |= uint64_t{1} << ((h2 >> 24) & 63);
+    }
+
+    constexpr bool bloomMayContain(const uint64_t (&bloom)[4], uint32_t rawId)
+    {
+        uint64_t probe[4] {};
+        bloomAdd(probe, rawId);
+        for (int i = 0; i < 4; ++i)
+            if ((bloom[i] & probe[i]) != probe[i]) return false;
+        return true;
+    }
+}
+
+} // namespace canmqtt::util
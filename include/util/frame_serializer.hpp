@@ -0,0 +1,75 @@
+#pragma once
+
+#include "bus/can_channel.hpp"
+#include "dbc/dbc_database.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace canmqtt::util {
+
+/// CAN frame kaydını (ts, bus, id, dlc, raw, name, signals) doğrudan yeniden
+/// kullanılan bir tampona JSON olarak yazar. Anahtar parçaları ve sinyal adı
+/// anahtarları önceden hazırlanır; kararlı durumda heap ayırmaz.
+class FrameSerializer {
+public:
+    explicit FrameSerializer(bool pretty = false);
+
+    void setPretty(bool pretty) { pretty_ = pretty; }
+    bool pretty() const { return pretty_; }
+
+    /// Kayıt tamponu: bir sonraki serialize() çağrısına kadar geçerli
+    const std::string& serialize(const bus::Frame& frame,
+                                 std::string_view busName,
+                                 const dbc::DbcDatabase& db,
+                                 dbc::MessageHandle msg,
+                                 const dbc::DecodedSignals& sigs);
+
+    /// Aynı kaydı dış bir tampona ekler (toplu gönderim için)
+    void append(std::string& out,
+                const bus::Frame& frame,
+                std::string_view busName,
+                const dbc::DbcDatabase& db,
+                dbc::MessageHandle msg,
+                const dbc::DecodedSignals& sigs);
+
+    /// Payload'ı frame dışında olan kayıtlar (J1939 TP, 1785 bayta kadar):
+    /// frame yalnızca başlık alanları (ts, id, kanal, bayraklar) için okunur
+    const std::string& serialize(const bus::Frame& frame,
+                                 std::span<const uint8_t> payload,
+                                 std::string_view busName,
+                                 const dbc::DbcDatabase& db,
+                                 dbc::MessageHandle msg,
+                                 const dbc::DecodedSignals& sigs);
+
+    void append(std::string& out,
+                const bus::Frame& frame,
+                std::span<const uint8_t> payload,
+                std::string_view busName,
+                const dbc::DbcDatabase& db,
+                dbc::MessageHandle msg,
+                const dbc::DecodedSignals& sigs);
+
+private:
+    void bind(const dbc::DbcDatabase& db);
+
+    bool pretty_;
+    std::string buf_;
+    const dbc::DbcDatabase* bound_ {nullptr};
+    uint64_t boundFingerprint_ {0};
+    std::vector<std::string> sigKeys_;      ///< global sinyal indeksi → "\"Ad\""
+};
+
+/// JSON string içeriğini kaçışlı olarak ekler (tırnaklar hariç)
+void appendEscaped(std::string& out, std::string_view s);
+/// En kısa geri-dönüşümlü ondalık gösterim; NaN/Inf → null
+void appendNumber(std::string& out, double v);
+void appendNumber(std::string& out, int64_t v);
+void appendNumber(std::string& out, uint64_t v);
+/// "AA BB CC" biçiminde büyük harf hex
+void appendHex(std::string& out, const uint8_t* d, std::size_t len);
+
+} // namespace canmqtt::util
@@ -1,6 +1,6 @@
 #pragma once
 
 
-#include "util/json_utils.inl"
+#include "util/frame_serializer.hpp"
 
 
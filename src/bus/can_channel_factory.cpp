@@ -1,6 +1,7 @@
 // src/bus/can_channel_factory.cpp
 #include "bus/can_channel.hpp"
 #include "bus/socket_can_channel.hpp"
+#include "bus/replay_channel.hpp"
 #include <iostream>
 #include <memory>
 
@@ -11,18 +12,21 @@
 
 namespace canmqtt::bus {
 
-ICanChannel* ICanChannel::create(std::string_view backend) {
+std::unique_ptr<ICanChannel> ICanChannel::create(std::string_view backend, std::string_view section) {
     if (backend == "socketcan" || backend == "virtual" || backend == "vcan") {
 #ifdef __linux__
-    return &SocketCanChannel::getInstance();
+    return std::make_unique<SocketCanChannel>();
 #else
     std::cerr << "[ICanChannel::create] SocketCAN sadece Linux'ta desteklenir.\n";
     return nullptr;
 #endif
     }
+    if (backend == "replay") {
+        return std::make_unique<ReplayChannel>(std::string(section));
+    }
 #ifdef USE_PCAN
     if (backend == "pcan") {
-        return PcanChannel::instance();
+        return std::make_unique<PcanChannel>(std::string(section));
     }
 #else
     if (backend == "pcan") {
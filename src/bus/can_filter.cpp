@@ -0,0 +1,149 @@
+#include "bus/can_filter.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <unordered_set>
+
+namespace canmqtt::bus {
+
+namespace {
+
+uint64_t key(const CanFilter& f) { return (uint64_t{f.mask} << 32) | f.id; }
+
+/// a, b'nin kabul ettiği her ID'yi kabul ediyor mu
+bool covers(const CanFilter& a, const CanFilter& b)
+{
+    return (a.mask & b.mask) == a.mask && (b.id & a.mask) == a.id;
+}
+
+void dedup(std::vector<CanFilter>& v)
+{
+    std::sort(v.begin(), v.end(), [](const CanFilter& a, const CanFilter& b) { return key(a) < key(b); });
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+}
+
+/// Aynı maskeli ve tek bitte ayrışan çiftleri o bit "önemsiz" olacak şekilde birleştirir
+void mergeAdjacent(std::vector<CanFilter>& v)
+{
+    for (bool changed = true; changed;) {
+        changed = false;
+        std::unordered_set<uint64_t> present;
+        present.reserve(v.size() * 2);
+        for (const auto& f : v) present.insert(key(f));
+
+        std::unordered_set<uint64_t> consumed;
+        std::vector<CanFilter> next;
+        next.reserve(v.size());
+        for (const auto& f : v) {
+            if (consumed.count(key(f))) continue;
+            bool merged = false;
+            for (uint32_t bits = f.mask & kEffMask; bits; bits &= bits - 1) {
+                const uint32_t bit = bits & (~bits + 1);
+                const CanFilter partner {f.id ^ bit, f.mask};
+                if (!present.count(key(partner)) || consumed.count(key(partner))) continue;
+                consumed.insert(key(f));
+                consumed.insert(key(partner));
+                next.push_back({f.id & ~bit, f.mask & ~bit});
+                merged = changed = true;
+                break;
+            }
+            if (!merged) next.push_back(f);
+        }
+        v.swap(next);
+        dedup(v);
+    }
+}
+
+/// Başka bir filtrenin zaten kabul ettiği filtreleri atar
+void dropCovered(std::vector<CanFilter>& v)
+{
+    std::stable_sort(v.begin(), v.end(), [](const CanFilter& a, const CanFilter& b) {
+        return std::popcount(a.mask) < std::popcount(b.mask);          // geniş filtreler önce
+    });
+    std::vector<CanFilter> kept;
+    kept.reserve(v.size());
+    for (const auto& f : v)
+        if (std::none_of(kept.begin(), kept.end(), [&](const CanFilter& k) { return covers(k, f); }))
+            kept.push_back(f);
+    v.swap(kept);
+}
+
+void simplify(std::vector<CanFilter>& v)
+{
+    dedup(v);
+    mergeAdjacent(v);
+    dropCovered(v);
+}
+
+} // namespace
+
+CanFilter ExactFilter(uint32_t id, bool extended)
+{
+    if (extended) return {(id & kEffMask) | kFilterEff, kEffMask | kFilterEff};
+    return {id & kSffMask, kSffMask | kFilterEff};
+}
+
+bool ParseFilterList(std::string_view text, std::vector<CanFilter>& out)
+{
+    auto parseHex = [](std::string_view s, uint32_t& v) {
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+        while (!s.empty() && (s.back()  == ' ' || s.back()  == '\t' || s.back() == '\r')) s.remove_suffix(1);
+        if (s.size() > 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) s.remove_prefix(2);
+        if (s.empty()) return false;
+        auto r = std::from_chars(s.data(), s.data() + s.size(), v, 16);
+        return r.ec == std::errc{} && r.ptr == s.data() + s.size();
+    };
+
+    bool ok = true;
+    while (!text.empty()) {
+        const auto comma = text.find(',');
+        std::string_view item = text.substr(0, comma);
+        text = comma == std::string_view::npos ? std::string_view{} : text.substr(comma + 1);
+        if (item.find_first_not_of(" \t\r") == std::string_view::npos) continue;
+
+        const auto slash = item.find('/');
+        uint32_t id = 0, mask = 0;
+        if (!parseHex(item.substr(0, slash), id) ||
+            (slash != std::string_view::npos && !parseHex(item.substr(slash + 1), mask))) {
+            ok = false;
+            continue;
+        }
+        const bool ext = (id & kFilterEff) || (id & kEffMask) > kSffMask;
+        CanFilter f = ExactFilter(id, ext);
+        if (slash != std::string_view::npos)
+            f.mask = (mask & (ext ? kEffMask : kSffMask)) | kFilterEff;
+        f.id &= f.mask;
+        out.push_back(f);
+    }
+    return ok;
+}
+
+std::vector<CanFilter> CompactFilters(std::vector<CanFilter> filters, std::size_t maxCount)
+{
+    // Ters filtreler (CAN_INV_FILTER) birleştirilmez, olduğu gibi sona eklenir
+    std::vector<CanFilter> inverted;
+    std::vector<CanFilter> v;
+    v.reserve(filters.size());
+    for (auto f : filters) {
+        f.id &= f.mask;
+        (f.invert ? inverted : v).push_back(f);
+    }
+
+    simplify(v);
+
+    // Kayıpsız birleştirme yetmediyse en düşük bitten başlayarak gevşet
+    const std::size_t limit = maxCount > inverted.size() ? maxCount - inverted.size() : 1;
+    for (uint32_t bit = 1; v.size() > limit && (bit & kEffMask); bit <<= 1) {
+        for (auto& f : v) {
+            f.mask &= ~bit;
+            f.id   &= f.mask;
+        }
+        simplify(v);
+    }
+
+    v.insert(v.end(), inverted.begin(), inverted.end());
+    return v;
+}
+
+} // namespace canmqtt::bus
@@ -0,0 +1,199 @@
+#include "bus/j1939_tp.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace canmqtt::bus {
+
+namespace {
+
+constexpr uint8_t kRts   = 16;
+constexpr uint8_t kCts   = 17;
+constexpr uint8_t kEoma  = 19;
+constexpr uint8_t kBam   = 32;
+constexpr uint8_t kAbort = 255;
+
+constexpr uint32_t kPfTpCm = 0xEC;
+
+} // namespace
+
+J1939Reassembler::J1939Reassembler(std::size_t maxSessions, std::chrono::milliseconds timeout)
+    : pool_(std::clamp<std::size_t>(maxSessions, 1, kEmpty - 1)), timeout_(timeout)
+{
+    // Yük faktörü ≤ 0.5: doğrusal yoklama kısa kalır
+    const std::size_t tableSize = std::bit_ceil(pool_.size() * 2);
+    table_.assign(tableSize, kEmpty);
+    mask_ = tableSize - 1;
+    shift_ = 32 - std::countr_zero(tableSize);
+
+    free_.reserve(pool_.size());
+    for (std::size_t i = pool_.size(); i-- > 0;)
+        free_.push_back(static_cast<uint16_t>(i));
+}
+
+J1939Reassembler::Session* J1939Reassembler::find(uint32_t key)
+{
+    for (std::size_t i = slotOf(key);; i = (i + 1) & mask_) {
+        const uint16_t idx = table_[i];
+        if (idx == kEmpty) return nullptr;
+        if (pool_[idx].key == key) return &pool_[idx];
+    }
+}
+
+J1939Reassembler::Session* J1939Reassembler::acquire(uint32_t key)
+{
+    if (free_.empty()) return nullptr;
+    const uint16_t idx = free_.back();
+    free_.pop_back();
+
+    std::size_t i = slotOf(key);
+    while (table_[i] != kEmpty) i = (i + 1) & mask_;
+    table_[i] = idx;
+
+    Session& s = pool_[idx];
+    s.key = key;
+    s.active = true;
+    s.received = 0;
+    std::memset(s.have, 0, sizeof(s.have));
+    ++used_;
+    return &s;
+}
+
+void J1939Reassembler::release(Session& s)
+{
+    const uint16_t idx = static_cast<uint16_t>(&s - pool_.data());
+    std::size_t i = slotOf(s.key);
+    while (table_[i] != idx) i = (i + 1) & mask_;
+
+    // Geri kaydırmalı silme: mezar taşı bırakmadan zinciri kapat
+    for (std::size_t j = (i + 1) & mask_; table_[j] != kEmpty; j = (j + 1) & mask_) {
+        const std::size_t home = slotOf(pool_[table_[j]].key);
+        // j'deki girdi i'ye taşınabilir mi (home, (i, j] aralığında değilse)
+        const bool between = i <= j ? (home > i && home <= j) : (home > i || home <= j);
+        if (!between) {
+            table_[i] = table_[j];
+            i = j;
+        }
+    }
+    table_[i] = kEmpty;
+
+    s.active = false;
+    free_.push_back(idx);
+    --used_;
+}
+
+J1939Reassembler::Result J1939Reassembler::feed(const Frame& f, Message& out)
+{
+    if (!isTp(f)) return Result::NotTp;
+    const uint8_t sa = static_cast<uint8_t>(f.id);
+    const uint8_t da = static_cast<uint8_t>(f.id >> 8);
+    if (((f.id >> 16) & 0xFF) == kPfTpCm) return onControl(f, sa, da);
+    return onData(f, sa, da, out);
+}
+
+J1939Reassembler::Result J1939Reassembler::onControl(const Frame& f, uint8_t sa, uint8_t da)
+{
+    if (f.len < 8) { ++stats_.invalid; return Result::Consumed; }
+    const uint8_t* d = f.data;
+
+    switch (d[0]) {
+    case kRts:
+    case kBam: {
+        const uint16_t size = static_cast<uint16_t>(d[1] | d[2] << 8);
+        const uint8_t packets = d[3];
+        if (size < 9 || size > kMaxPayload || packets != (size + 6) / 7) {
+            ++stats_.invalid;
+            return Result::Consumed;
+        }
+        // BAM her zaman global adrese gider; yeni duyuru/RTS süren oturumu geçersiz kılar
+        const uint32_t key = makeKey(f.channel, sa, d[0] == kBam ? 0xFF : da);
+        Session* s = find(key);
+        if (s) {
+            ++stats_.aborted;
+            s->received = 0;
+            std::memset(s->have, 0, sizeof(s->have));
+        } else if (!(s = acquire(key))) {
+            ++stats_.noSession;
+            return Result::Consumed;
+        }
+        s->pgn      = static_cast<uint32_t>(d[5] | d[6] << 8 | (d[7] & 0x03) << 16);
+        s->size     = size;
+        s->packets  = packets;
+        s->priority = static_cast<uint8_t>((f.id >> 26) & 0x7);
+        s->last     = f.ts;
+        return Result::Consumed;
+    }
+    case kAbort: {
+        // Her iki taraf da iptal edebilir: gönderenin ya da alıcının adresinden gelir
+        Session* s = find(makeKey(f.channel, sa, da));
+        if (!s) s = find(makeKey(f.channel, da, sa));
+        if (s) {
+            ++stats_.aborted;
+            release(*s);
+        }
+        return Result::Consumed;
+    }
+    case kCts:
+    case kEoma:
+    default:
+        // Akış kontrolü alıcıdan gelir; pasif dinleyici yalnızca veriyi izler
+        return Result::Consumed;
+    }
+}
+
+J1939Reassembler::Result J1939Reassembler::onData(const Frame& f, uint8_t sa, uint8_t da, Message& out)
+{
+    Session* s = find(makeKey(f.channel, sa, da));
+    if (!s) {
+        ++stats_.noSession;
+        return Result::Consumed;
+    }
+    if (f.ts - s->last > timeout_) {
+        ++stats_.timedOut;
+        release(*s);
+        return Result::Consumed;
+    }
+
+    const uint8_t seq = f.len > 0 ? f.data[0] : 0;
+    if (seq == 0 || seq > s->packets) {
+        ++stats_.invalid;
+        return Result::Consumed;
+    }
+    s->last = f.ts;
+
+    // CTS ile yeniden istenen paketler aynı yere yazılır, bir kez sayılır
+    const std::size_t at = std::size_t{seq - 1u} * 7;
+    const std::size_t n = std::min<std::size_t>(7, s->size - std::min<std::size_t>(at, s->size));
+    std::memcpy(s->data + at, f.data + 1, std::min<std::size_t>(n, f.len > 0 ? f.len - 1u : 0));
+    uint64_t& word = s->have[(seq - 1) >> 6];
+    const uint64_t bit = uint64_t{1} << ((seq - 1) & 63);
+    if (!(word & bit)) {
+        word |= bit;
+        ++s->received;
+    }
+    if (s->received != s->packets) return Result::Consumed;
+
+    // PDU1 (PF < 240) PGN'lerinde PS alanı hedef adrestir
+    const uint32_t pf = (s->pgn >> 8) & 0xFF;
+    const uint32_t pgn = pf < 240 ? ((s->pgn & 0x3FF00) | da) : s->pgn;
+    out.id      = (uint32_t{s->priority} << 26) | (pgn << 8) | sa;
+    out.channel = f.channel;
+    out.ts      = f.ts;
+    out.data    = std::span<const uint8_t>(s->data, s->size);
+    ++stats_.completed;
+    release(*s);                               // tampon bir sonraki acquire'a kadar geçerli
+    return Result::Complete;
+}
+
+void J1939Reassembler::expire(std::chrono::microseconds now)
+{
+    if (used_ == 0) return;
+    for (auto& s : pool_)
+        if (s.active && now - s.last > timeout_) {
+            ++stats_.timedOut;
+            release(s);
+        }
+}
+
+} // namespace canmqtt::bus
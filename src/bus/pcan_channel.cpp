@@ -7,20 +7,29 @@
 #include <string>
 #include <thread>
 #include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
 #if defined(_WIN32)
 #  include <windows.h>
 #else
 #  include <dlfcn.h>
+#  include <poll.h>
 #endif
 
 namespace canmqtt::bus {
 
 // PCAN hata kodunu string'e çeviren yardımcı (şimdilik minimal)
 static const char* pcanStatusToStr(PcanStatus st) {
-    switch(st) {
-        case PCAN_ERROR_OK: return "OK";
-        default: return "Bilinmeyen hata";
-    }
+    if(st == PCAN_ERROR_OK)        return "OK";
+    if(st & PCAN_ERROR_QOVERRUN)   return "alım kuyruğu taştı";
+    if(st & PCAN_ERROR_OVERRUN)    return "denetleyici taştı";
+    if(st & PCAN_ERROR_BUSOFF)     return "bus-off";
+    if(st & PCAN_ERROR_BUSHEAVY)   return "bus-heavy";
+    if(st & PCAN_ERROR_BUSLIGHT)   return "bus-light";
+    if(st & PCAN_ERROR_QRCVEMPTY)  return "alım kuyruğu boş";
+    return "Bilinmeyen hata";
 }
 
 // Bitrate map (PCANBasic baudrate çarpanı). Basit standart değerler.
@@ -37,9 +46,13 @@ static uint16_t mapBitrate(const std::string& br) {
     return 0x031C; // default 125K
 }
 
-PcanChannel* PcanChannel::instance() {
-    static PcanChannel inst;
-    return &inst;
+// 500K nominal / 2M data @ 80 MHz (PCAN-USB FD varsayılan saat)
+static constexpr const char* kDefaultBitrateFD =
+    "f_clock_mhz=80,nom_brp=2,nom_tseg1=63,nom_tseg2=16,nom_sjw=16,"
+    "data_brp=2,data_tseg1=15,data_tseg2=4,data_sjw=4";
+
+PcanChannel::~PcanChannel() {
+    close();
 }
 
 bool PcanChannel::loadLibrary() {
@@ -67,10 +80,14 @@ bool PcanChannel::loadLibrary() {
     }
     auto loadSym = [&](const char* name){ return dlsym(libHandle_, name); };
 #endif
-    fpInitialize_   = reinterpret_cast<CAN_Initialize_t>(loadSym("CAN_InitializeFD"));
-    if(!fpInitialize_) fpInitialize_ = reinterpret_cast<CAN_Initialize_t>(loadSym("CAN_Initialize"));
+    fpInitialize_   = reinterpret_cast<CAN_Initialize_t>(loadSym("CAN_Initialize"));
+    fpInitializeFD_ = reinterpret_cast<CAN_InitializeFD_t>(loadSym("CAN_InitializeFD"));
     fpUninitialize_ = reinterpret_cast<CAN_Uninitialize_t>(loadSym("CAN_Uninitialize"));
     fpRead_         = reinterpret_cast<CAN_Read_t>(loadSym("CAN_Read"));
+    fpReadFD_       = reinterpret_cast<CAN_ReadFD_t>(loadSym("CAN_ReadFD"));
+    fpSetValue_     = reinterpret_cast<CAN_SetValue_t>(loadSym("CAN_SetValue"));
+    fpGetValue_     = reinterpret_cast<CAN_GetValue_t>(loadSym("CAN_GetValue"));
+    fpFilterMessages_ = reinterpret_cast<CAN_FilterMessages_t>(loadSym("CAN_FilterMessages"));
     if(!fpInitialize_ || !fpUninitialize_ || !fpRead_) {
         std::cerr << "[PcanChannel] Gerekli semboller bulunamadı\n";
         return false;
@@ -96,36 +113,246 @@ bool PcanChannel::parseChannel(std::string_view ifname, PcanHandle &outHandle) {
     return false;
 }
 
-bool PcanChannel::open(std::string_view ifname, bool /*fd_mode*/) {
+bool PcanChannel::open(std::string_view ifname, bool fd_mode) {
     if(opened_) return true;
     if(!loadLibrary()) return false;
     if(!parseChannel(ifname, handle_)) return false;
 
-    // Bitrate config.ini'den okunuyor
     auto& cfg = canmqtt::config::ConfigLoader::getInstance();
-    std::string bitrateStr = cfg.Get("can", "bitrate", "500K");
+    if(fd_mode) {
+        // FD bit timing string'i (TPCANBitrateFD) config.ini'den okunuyor
+        if(!fpInitializeFD_ || !fpReadFD_) {
+            std::cerr << "[PcanChannel] Kütüphane CAN FD desteklemiyor (CAN_InitializeFD/CAN_ReadFD yok)\n";
+            return false;
+        }
+        std::string bitrateFd = cfg.Get(section_, "bitrate_fd", cfg.Get("can", "bitrate_fd", kDefaultBitrateFD));
+        if(fpInitializeFD_(handle_, bitrateFd.c_str()) != PCAN_ERROR_OK) {
+            std::cerr << "[PcanChannel] CAN_InitializeFD başarısız (bitrate_fd: " << bitrateFd << ")\n";
+            return false;
+        }
+        fdMode_ = true;
+        opened_ = true;
+        if(!setupReceiveEvent())
+            std::cerr << "[PcanChannel] PCAN_RECEIVE_EVENT alınamadı, 1 ms yoklamaya düşülüyor\n";
+        std::cout << "[PcanChannel] Açıldı (FD): kanal=" << ifname << " bitrate_fd=" << bitrateFd << std::endl;
+        return true;
+    }
+
+    // Bitrate config.ini'den okunuyor
+    std::string bitrateStr = cfg.Get(section_, "bitrate", cfg.Get("can", "bitrate", "500K"));
     uint16_t bitrate = mapBitrate(bitrateStr);
-    if(fpInitialize_(handle_, bitrate, 0,0,0,0) != PCAN_ERROR_OK) {
+    if(fpInitialize_(handle_, bitrate, 0, 0, 0) != PCAN_ERROR_OK) {
         std::cerr << "[PcanChannel] CAN_Initialize başarısız (bitrate: " << bitrateStr << ")\n";
         return false;
     }
+    fdMode_ = false;
     opened_ = true;
+    if(!setupReceiveEvent())
+        std::cerr << "[PcanChannel] PCAN_RECEIVE_EVENT alınamadı, 1 ms yoklamaya düşülüyor\n";
     std::cout << "[PcanChannel] Açıldı: kanal=" << ifname << " bitrate=" << bitrateStr << std::endl;
     return true;
 }
 
-bool PcanChannel::read(Frame& out) {
+bool PcanChannel::setupReceiveEvent() {
+#if defined(_WIN32)
+    if(!fpSetValue_) return false;
+    event_ = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if(!event_) return false;
+    if(fpSetValue_(handle_, PCAN_RECEIVE_EVENT, &event_, sizeof(event_)) != PCAN_ERROR_OK) {
+        CloseHandle(event_);
+        event_ = nullptr;
+        return false;
+    }
+    return true;
+#else
+    if(!fpGetValue_) return false;
+    int fd = -1;
+    if(fpGetValue_(handle_, PCAN_RECEIVE_EVENT, &fd, sizeof(fd)) != PCAN_ERROR_OK || fd < 0) return false;
+    eventFd_ = fd;
+    return true;
+#endif
+}
+
+bool PcanChannel::waitReceive(int timeoutMs) {
+#if defined(_WIN32)
+    if(event_) return WaitForSingleObject(event_, static_cast<DWORD>(timeoutMs)) == WAIT_OBJECT_0;
+#else
+    if(eventFd_ >= 0) {
+        pollfd pfd{eventFd_, POLLIN, 0};
+        return ::poll(&pfd, 1, timeoutMs) > 0;
+    }
+#endif
+    // Olay mekanizması yoksa kısa uyku ile yoklama
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return true;
+}
+
+void PcanChannel::reportStatus(PcanStatus st) {
+    if(st & (PCAN_ERROR_OVERRUN | PCAN_ERROR_QOVERRUN)) ++dropped_;
+
+    // Aynı hata her okumada tekrarlanabilir: saniyede en fazla bir satır
+    const auto now = std::chrono::steady_clock::now();
+    if(now - lastErrorLog_ < std::chrono::seconds(1)) {
+        ++suppressedErrors_;
+        return;
+    }
+    std::cerr << "[PcanChannel] CAN_Read hata 0x" << std::hex << static_cast<uint32_t>(st) << std::dec
+              << " (" << pcanStatusToStr(st) << ")";
+    if(suppressedErrors_) std::cerr << ", son 1 sn'de " << suppressedErrors_ << " tekrar";
+    std::cerr << "\n";
+    suppressedErrors_ = 0;
+    lastErrorLog_ = now;
+}
+
+std::chrono::microseconds PcanChannel::toSteady(uint64_t hwUs, int64_t hostUs) {
+    // Frame'ler host'a yalnızca gecikmeyle ulaşır: en küçük fark en iyi ofset tahminidir.
+    // Saatler arasındaki kaymayı (≤100 ppm) izlemek için ofset yukarı doğru sınırlı hızla kayar;
+    // 1 sn'den büyük sıçrama adaptör saatinin sıfırlandığı anlamına gelir.
+    const int64_t sample = hostUs - static_cast<int64_t>(hwUs);
+    if(!synced_ || sample < offsetUs_ || sample - offsetUs_ > 1'000'000) {
+        offsetUs_ = sample;
+        synced_ = true;
+    } else {
+        const int64_t creep = (hostUs - lastSyncHostUs_) / 10'000;
+        offsetUs_ += std::min(sample - offsetUs_, creep);
+    }
+    lastSyncHostUs_ = hostUs;
+    return std::chrono::microseconds(static_cast<int64_t>(hwUs) + offsetUs_);
+}
+
+PcanStatus PcanChannel::readOne(Frame& out, bool& valid) {
+    const int64_t hostUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    uint8_t msgtype = 0;
+    uint64_t hwUs = 0;
+    valid = false;
+
+    if(fdMode_) {
+        PcanMsgFD msg{};
+        PcanTimestampFD ts = 0;
+        auto st = fpReadFD_(handle_, &msg, &ts);
+        if(st != PCAN_ERROR_OK) return st;
+        msgtype = msg.msgtype;
+        out.id  = msg.id;
+        out.len = FdDlcToLen(msg.dlc);
+        std::memcpy(out.data, msg.data, Frame::kMaxData);
+        if (out.len < 8) std::memset(out.data + out.len, 0, 8 - out.len);
+        hwUs = ts;
+    } else {
+        PcanMsg msg{};
+        PcanTimestamp ts{};
+        auto st = fpRead_(handle_, &msg, &ts);
+        if(st != PCAN_ERROR_OK) return st;
+        msgtype = msg.msgtype;
+        out.id  = msg.id;
+        out.len = static_cast<uint8_t>(std::min<size_t>(msg.len, 8));
+        std::memcpy(out.data, msg.data, 8);
+        std::memset(out.data + out.len, 0, 8 - out.len);
+        hwUs = ts.micros + 1000ull * ts.millis + 0x100000000ull * 1000ull * ts.millis_overflow;
+    }
+
+    // Durum mesajları (bus-off vb.) veri frame'i değildir
+    if(msgtype & PCAN_MESSAGE_STATUS) return PCAN_ERROR_OK;
+
+    out.flags = 0;
+    if (msgtype & PCAN_MESSAGE_EXTENDED) out.flags |= Frame::kExt;
+    if (msgtype & PCAN_MESSAGE_RTR)      out.flags |= Frame::kRtr;
+    if (msgtype & PCAN_MESSAGE_FD)       out.flags |= Frame::kFd;
+    if (msgtype & PCAN_MESSAGE_BRS)      out.flags |= Frame::kBrs;
+    if (msgtype & PCAN_MESSAGE_ESI)      out.flags |= Frame::kEsi;
+    if (msgtype & PCAN_MESSAGE_ERRFRAME) out.flags |= Frame::kErr;
+    out.channel = 0;
+    out.ts = toSteady(hwUs, hostUs);
+    valid = true;
+    return PCAN_ERROR_OK;
+}
+
+void PcanChannel::drainQueue(std::span<Frame> out, std::size_t& count) {
+    while(count < out.size()) {
+        bool valid = false;
+        const PcanStatus st = readOne(out[count], valid);
+        if(st == PCAN_ERROR_OK) {
+            if(valid) ++count;
+            continue;
+        }
+        if(st & PCAN_ERROR_QRCVEMPTY) break;           // kuyruk boşaldı: normal durum
+        reportStatus(st);
+        if(!(st & (PCAN_ERROR_OVERRUN | PCAN_ERROR_QOVERRUN))) break;
+    }
+}
+
+bool PcanChannel::readBatch(std::span<Frame> out, std::size_t& count) {
+    count = 0;
+    if(!opened_) return false;
+
+    // Önce kuyruktakileri al; boşsa olayı bekleyip bir kez daha boşalt
+    drainQueue(out, count);
+    if(count == 0 && waitReceive(100)) drainQueue(out, count);
+    return true;
+}
+
+bool PcanChannel::drain(std::span<Frame> out, std::size_t& count) {
+    count = 0;
     if(!opened_) return false;
-    PcanMsg msg{}; 
-    auto st = fpRead_(handle_, &msg, nullptr);
-    if(st != PCAN_ERROR_OK) {
-        std::cerr << "[PcanChannel] CAN_Read hata: " << pcanStatusToStr(st) << "\n";
-        std::this_thread::sleep_for(std::chrono::milliseconds(2));
-        return true; // Thread devam etsin ama çerçeve yok.
-    }
-    out.id = msg.id; // EXT/RTR maskesine ileride bakılabilir
-    out.data.assign(msg.data, msg.data + std::min<size_t>(msg.len, 8));
-    out.ts = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch());
+    // Olay yalnızca durum mesajları için de tetiklenebilir: boş dönmek normaldir
+    drainQueue(out, count);
+    return true;
+}
+
+bool PcanChannel::read(Frame& out) {
+    std::size_t n = 0;
+    do {
+        if(!readBatch(std::span<Frame>(&out, 1), n)) return false;
+    } while(n == 0);
+    return true;
+}
+
+bool PcanChannel::setFilters(std::span<const CanFilter> filters) {
+    if(!opened_ || (!fpSetValue_ && !fpFilterMessages_)) return false;
+
+    // Tip başına: ortak maske = tüm maskelerin kesişimi eksi ID'lerin ayrıştığı bitler
+    struct Acc { bool any {false}; uint32_t code {}; uint32_t mask {}; uint32_t lo {UINT32_MAX}; uint32_t hi {0}; };
+    Acc std11, ext29;
+    for(const auto& f : filters) {
+        if(f.invert) {
+            std::cerr << "[PcanChannel] Ters filtre desteklenmiyor\n";
+            return false;
+        }
+        const bool ext = f.id & kFilterEff;
+        Acc& a = ext ? ext29 : std11;
+        const uint32_t idMask = ext ? kEffMask : kSffMask;
+        const uint32_t mask = f.mask & idMask;
+        const uint32_t id   = f.id & mask;
+        if(!a.any) { a.any = true; a.code = id; a.mask = mask; }
+        else       { a.mask &= mask & ~(a.code ^ id); a.code &= a.mask; }
+        a.lo = std::min(a.lo, id);
+        a.hi = std::max(a.hi, id | (~mask & idMask));
+    }
+
+    auto apply = [&](const Acc& a, bool ext) {
+        if(!a.any) return true;          // bu tipte filtre yok: açık kalır
+        const uint32_t idMask = ext ? kEffMask : kSffMask;
+        if(fpSetValue_) {
+            uint64_t value = (uint64_t{a.code} << 32) | (~a.mask & idMask);
+            const PcanStatus st = fpSetValue_(handle_, ext ? PCAN_ACCEPTANCE_FILTER_29BIT : PCAN_ACCEPTANCE_FILTER_11BIT,
+                                              &value, sizeof(value));
+            if(st == PCAN_ERROR_OK) return true;
+            std::cerr << "[PcanChannel] CAN_SetValue(" << (ext ? "29" : "11") << "-bit kabul filtresi) hata 0x"
+                      << std::hex << static_cast<uint32_t>(st) << std::dec << "\n";
+            if(!fpFilterMessages_) return false;
+            // Eski sürücü kod/maske parametresini tanımayabilir: aralık filtresine düş
+        }
+        const PcanStatus st = fpFilterMessages_(handle_, a.lo, a.hi, ext ? PCAN_MODE_EXTENDED : PCAN_MODE_STANDARD);
+        if(st == PCAN_ERROR_OK) return true;
+        std::cerr << "[PcanChannel] CAN_FilterMessages hata 0x" << std::hex << static_cast<uint32_t>(st) << std::dec << "\n";
+        return false;
+    };
+    if(!apply(std11, false) || !apply(ext29, true)) {
+        std::cerr << "[PcanChannel] Kabul filtresi yüklenemedi\n";
+        return false;
+    }
+    std::cout << std::hex << "[PcanChannel] Kabul filtresi: 11-bit kod=0x" << std11.code << " maske=0x" << std11.mask
+              << ", 29-bit kod=0x" << ext29.code << " maske=0x" << ext29.mask << std::dec << std::endl;
     return true;
 }
 
@@ -133,6 +360,12 @@ void PcanChannel::close() {
     if(opened_ && fpUninitialize_) {
         fpUninitialize_(handle_);
         opened_ = false;
+        fdMode_ = false;
+        eventFd_ = -1;
+        synced_ = false;
+#if defined(_WIN32)
+        if(event_) { CloseHandle(event_); event_ = nullptr; }
+#endif
         std::cout << "[PcanChannel] Kapatıldı\n";
     }
     if(libHandle_) {
@@ -0,0 +1,511 @@
+// src/bus/replay_channel.cpp
+#include "bus/replay_channel.hpp"
+#include "config/config_loader.hpp"
+#include "util/capture_format.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+namespace canmqtt::bus {
+
+namespace fs = std::filesystem;
+namespace cap = util::capture;
+
+namespace {
+
+void trim(std::string_view& s)
+{
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back()  == ' ' || s.back()  == '\t' || s.back() == '\r')) s.remove_suffix(1);
+}
+
+/// Boşlukla ayrılmış sonraki kelime
+std::string_view token(std::string_view& s)
+{
+    trim(s);
+    const auto end = std::min(s.find_first_of(" \t"), s.size());
+    const auto t = s.substr(0, end);
+    s.remove_prefix(end);
+    return t;
+}
+
+bool parseHex(std::string_view s, uint32_t& v)
+{
+    if (s.empty()) return false;
+    auto r = std::from_chars(s.data(), s.data() + s.size(), v, 16);
+    return r.ec == std::errc{} && r.ptr == s.data() + s.size();
+}
+
+bool parseUint(std::string_view s, uint32_t& v, int base = 10)
+{
+    if (s.empty()) return false;
+    auto r = std::from_chars(s.data(), s.data() + s.size(), v, base);
+    return r.ec == std::errc{} && r.ptr == s.data() + s.size();
+}
+
+/// "12.345678" → µs; double'a çevirmeden (uzun kayıtlarda hassasiyet kaybolmasın)
+bool parseSeconds(std::string_view s, int64_t& us)
+{
+    const auto dot = s.find('.');
+    int64_t sec = 0;
+    const auto intPart = s.substr(0, dot);
+    if (intPart.empty() || std::from_chars(intPart.data(), intPart.data() + intPart.size(), sec).ec != std::errc{})
+        return false;
+    int64_t frac = 0;
+    int digits = 0;
+    if (dot != std::string_view::npos)
+        for (char c : s.substr(dot + 1)) {
+            if (c < '0' || c > '9') return false;
+            if (digits < 6) { frac = frac * 10 + (c - '0'); ++digits; }
+        }
+    for (; digits < 6; ++digits) frac *= 10;
+    us = sec * 1'000'000 + frac;
+    return true;
+}
+
+uint8_t hexNibble(char c)
+{
+    if (c >= '0' && c <= '9') return static_cast<uint8_t>(c - '0');
+    if (c >= 'a' && c <= 'f') return static_cast<uint8_t>(c - 'a' + 10);
+    if (c >= 'A' && c <= 'F') return static_cast<uint8_t>(c - 'A' + 10);
+    return 0xFF;
+}
+
+void setId(Frame& f, uint32_t id, bool ext)
+{
+    f.id = ext ? (id & 0x1FFFFFFFu) : (id & 0x7FFu);
+    if (ext) f.flags |= Frame::kExt;
+}
+
+} // namespace
+
+class ReplayChannel::Reader {
+public:
+    virtual ~Reader() = default;
+    /// Sonraki frame; dosya bitince false. source boş değilse başka arayüzün frame'leri atlanır
+    virtual bool next(Frame& out, int64_t& tsUs) = 0;
+};
+
+namespace {
+
+/// candump -l: "(1436509052.249713) can0 18FEF100#0102030405060708"
+///   ID 3 hane = 11-bit, 8 hane = 29-bit; "ID#R" RTR; "ID##<bayrak><veri>" CAN FD
+class CandumpReader final : public ReplayChannel::Reader {
+public:
+    CandumpReader(std::ifstream in, std::string source) : in_(std::move(in)), source_(std::move(source)) {}
+
+    bool next(Frame& out, int64_t& tsUs) override
+    {
+        while (std::getline(in_, line_)) {
+            std::string_view s = line_;
+            trim(s);
+            if (s.size() < 4 || s.front() != '(') continue;
+            const auto close = s.find(')');
+            if (close == std::string_view::npos || !parseSeconds(s.substr(1, close - 1), tsUs)) continue;
+            s.remove_prefix(close + 1);
+
+            const auto iface = token(s);
+            if (!source_.empty() && iface != source_) continue;
+            if (parse(token(s), out)) return true;
+        }
+        return false;
+    }
+
+private:
+    static bool parse(std::string_view t, Frame& out)
+    {
+        const auto hash = t.find('#');
+        if (hash == std::string_view::npos) return false;
+        uint32_t id = 0;
+        if (!parseHex(t.substr(0, hash), id)) return false;
+
+        out = Frame{};
+        const bool ext = hash > 3;
+        if (ext && (id & 0x20000000u)) out.flags |= Frame::kErr;   // CAN_ERR_FLAG
+        setId(out, id, ext);
+
+        std::string_view data = t.substr(hash + 1);
+        if (!data.empty() && data.front() == '#') {                 // CAN FD
+            if (data.size() < 2) return false;
+            const uint8_t fl = hexNibble(data[1]);
+            if (fl == 0xFF) return false;
+            out.flags |= Frame::kFd;
+            if (fl & 0x1) out.flags |= Frame::kBrs;
+            if (fl & 0x2) out.flags |= Frame::kEsi;
+            data.remove_prefix(2);
+        } else if (!data.empty() && (data.front() == 'R' || data.front() == 'r')) {
+            out.flags |= Frame::kRtr;
+            uint32_t len = 0;
+            if (data.size() > 1 && parseUint(data.substr(1, 1), len) && len <= 8) out.len = static_cast<uint8_t>(len);
+            return true;
+        }
+
+        const std::size_t maxLen = (out.flags & Frame::kFd) ? Frame::kMaxData : 8;
+        for (std::size_t i = 0; i + 1 < data.size() && out.len < maxLen; ) {
+            if (data[i] == '.') { ++i; continue; }
+            const uint8_t hi = hexNibble(data[i]), lo = hexNibble(data[i + 1]);
+            if (hi == 0xFF || lo == 0xFF) return false;
+            out.data[out.len++] = static_cast<uint8_t>(hi << 4 | lo);
+            i += 2;
+        }
+        if (out.flags & Frame::kFd) out.len = FdDlcToLen(FdLenToDlc(out.len));   // FD uzunluğu DLC adımlarına
+        return true;
+    }
+
+    std::ifstream in_;
+    std::string source_;
+    std::string line_;
+};
+
+/// Vector ASC (CANalyzer/CANoe günlüğü):
+///   "0.001234 1  18FEF100x       Rx   d 8 01 02 03 04 05 06 07 08"
+///   "0.001234 CANFD   1 Rx 18FEF100x  Name 1 0 9 12 01 02 ..."
+/// "base hex|dec" ve "timestamps absolute|relative" başlıkları dikkate alınır.
+class AscReader final : public ReplayChannel::Reader {
+public:
+    AscReader(std::ifstream in, std::string source) : in_(std::move(in)), source_(std::move(source)) {}
+
+    bool next(Frame& out, int64_t& tsUs) override
+    {
+        while (std::getline(in_, line_)) {
+            std::string_view s = line_;
+            const auto first = token(s);
+            int64_t ts = 0;
+            if (!parseSeconds(first, ts)) {
+                header(first, s);
+                continue;
+            }
+            if (relative_) { lastUs_ += ts; ts = lastUs_; }
+            if (!parse(s, out)) continue;
+            tsUs = ts;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    void header(std::string_view first, std::string_view rest)
+    {
+        if (first == "base") {
+            base_ = token(rest) == "dec" ? 10 : 16;
+            if (token(rest) == "timestamps") relative_ = token(rest) == "relative";
+        }
+    }
+
+    bool parseId(std::string_view t, Frame& out) const
+    {
+        const bool ext = !t.empty() && (t.back() == 'x' || t.back() == 'X');
+        if (ext) t.remove_suffix(1);
+        uint32_t id = 0;
+        if (!parseUint(t, id, base_)) return false;
+        setId(out, id, ext || id > 0x7FF);
+        return true;
+    }
+
+    bool parse(std::string_view s, Frame& out)
+    {
+        out = Frame{};
+        auto ch = token(s);
+        const bool fd = ch == "CANFD";
+        if (fd) ch = token(s);
+        if (!source_.empty() && ch != source_) return false;
+
+        uint32_t dlc = 0;
+        if (fd) {
+            // kanal yön ID [sembolik ad] BRS ESI DLC uzunluk veri...
+            token(s);                                            // Rx/Tx
+            if (!parseId(token(s), out)) return false;
+            auto t = token(s);
+            if (t.size() != 1) t = token(s);                     // sembolik ad
+            if (t == "1") out.flags |= Frame::kBrs;
+            if (token(s) == "1") out.flags |= Frame::kEsi;
+            uint32_t len = 0;
+            if (!parseUint(token(s), dlc, 16) || !parseUint(token(s), len) || len > Frame::kMaxData) return false;
+            out.flags |= Frame::kFd;
+            out.len = static_cast<uint8_t>(len);
+        } else {
+            // kanal ID yön d|r DLC veri...
+            if (!parseId(token(s), out)) return false;          // ErrorFrame, istatistik satırları vb.
+            token(s);                                            // Rx/Tx
+            const auto kind = token(s);
+            if (kind == "r") { out.flags |= Frame::kRtr; return true; }
+            if (kind != "d" || !parseUint(token(s), dlc, 16) || dlc > 8) return false;
+            out.len = static_cast<uint8_t>(dlc);
+        }
+
+        for (uint8_t i = 0; i < out.len; ++i) {
+            uint32_t b = 0;
+            if (!parseHex(token(s), b)) return false;
+            out.data[i] = static_cast<uint8_t>(b);
+        }
+        return true;
+    }
+
+    std::ifstream in_;
+    std::string source_;
+    std::string line_;
+    int base_ {16};
+    bool relative_ {false};
+    int64_t lastUs_ {0};
+};
+
+/// Ham kayıt segmenti (.vcap); yalnızca dataEnd'e kadarki kayıtlar geçerli
+class VcapReader final : public ReplayChannel::Reader {
+public:
+    VcapReader(std::ifstream in, const std::string& source) : in_(std::move(in))
+    {
+        char head[cap::kDataOffset] {};
+        if (!in_.read(head, sizeof(head)) || std::memcmp(head, cap::kMagic, sizeof(cap::kMagic)) != 0) {
+            std::cerr << "[ReplayChannel] Geçersiz kayıt dosyası başlığı\n";
+            end_ = 0;
+            return;
+        }
+        cap::FileHeader h;
+        std::memcpy(&h, head, sizeof(h));
+        end_ = h.dataEnd;
+        pos_ = cap::kDataOffset;
+
+        if (source.empty()) return;
+        // Kaynak adı başlıktaki kanal listesinden indekse çevrilir
+        std::size_t at = sizeof(cap::FileHeader);
+        for (uint32_t i = 0; i < h.channelCount && at < sizeof(head); ++i) {
+            const std::string_view name(head + at, strnlen(head + at, sizeof(head) - at));
+            if (name == source) channel_ = static_cast<int>(i);
+            at += name.size() + 1;
+        }
+        if (channel_ < 0) end_ = 0;                              // bu dosyada o kanal yok
+    }
+
+    bool next(Frame& out, int64_t& tsUs) override
+    {
+        cap::RecordHeader rec;
+        while (pos_ + sizeof(rec) <= end_) {
+            if (!in_.read(reinterpret_cast<char*>(&rec), sizeof(rec))) return false;
+            const std::size_t size = cap::recordSize(rec.len);
+            const std::size_t body = size - sizeof(rec);
+            if (rec.len > Frame::kMaxData || pos_ + size > end_) return false;
+            pos_ += size;
+
+            out = Frame{};
+            if (!in_.read(reinterpret_cast<char*>(buf_), static_cast<std::streamsize>(body))) return false;
+            if (channel_ >= 0 && rec.channel != channel_) continue;
+
+            out.id    = rec.rawId & 0x1FFFFFFFu;
+            out.flags = rec.flags;
+            out.len   = rec.len;
+            std::memcpy(out.data, buf_, rec.len);
+            tsUs = rec.tsUs;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    std::ifstream in_;
+    uint64_t pos_ {0};
+    uint64_t end_ {0};
+    int channel_ {-1};
+    uint8_t buf_[cap::recordSize(Frame::kMaxData)] {};
+};
+
+} // namespace
+
+ReplayChannel::ReplayChannel(std::string section) : section_(std::move(section)) {}
+
+ReplayChannel::~ReplayChannel()
+{
+    close();
+}
+
+bool ReplayChannel::open(std::string_view ifname, [[maybe_unused]] bool fd_mode)
+{
+    close();
+    const fs::path path(ifname);
+    std::error_code ec;
+    if (fs::is_directory(path, ec)) {
+        for (const auto& e : fs::directory_iterator(path, ec)) {
+            const auto ext = e.path().extension();
+            if (e.is_regular_file() && (ext == ".vcap" || ext == ".log" || ext == ".asc"))
+                files_.push_back(e.path().string());
+        }
+        std::sort(files_.begin(), files_.end());
+    } else {
+        files_.emplace_back(ifname);
+    }
+    if (files_.empty()) {
+        std::cerr << "[ReplayChannel] Oynatılacak dosya yok: " << ifname << "\n";
+        return false;
+    }
+
+    auto& cfg = config::ConfigLoader::getInstance();
+    speed_ = cfg.GetNumber(section_, "speed", cfg.GetNumber("replay", "speed", 1.0));
+    if (speed_ < 0) speed_ = 0;
+    loop_   = cfg.Get(section_, "loop", cfg.Get("replay", "loop", "0")) == "1";
+    source_ = cfg.Get(section_, "source", cfg.Get("replay", "source", ""));
+
+    if (!openFile(0)) return false;
+    started_ = Clock::now();
+    std::cout << "[ReplayChannel] Açıldı: " << ifname << " (" << files_.size() << " dosya, hız ";
+    if (speed_ > 0) std::cout << speed_ << "x";
+    else            std::cout << "azami";
+    std::cout << (loop_ ? ", döngü" : "") << ")" << std::endl;
+    return true;
+}
+
+bool ReplayChannel::openFile(std::size_t index)
+{
+    reader_.reset();
+    fileIndex_ = index;
+    const std::string& file = files_[index];
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+        std::cerr << "[ReplayChannel] Açılamadı: " << file << "\n";
+        return false;
+    }
+
+    // Uzantı yoksa içerikten: "VCANCAP" ham kayıt, '(' ile başlayan candump
+    const auto ext = fs::path(file).extension();
+    char sniff[8] {};
+    in.read(sniff, sizeof(sniff));
+    in.clear();
+    in.seekg(0);
+    const std::string_view head(sniff, static_cast<std::size_t>(in.gcount() > 0 ? in.gcount() : 0));
+
+    if (ext == ".vcap" || head.starts_with(std::string_view(cap::kMagic, 7)))
+        reader_ = std::make_unique<VcapReader>(std::move(in), source_);
+    else if (ext == ".asc")
+        reader_ = std::make_unique<AscReader>(std::move(in), source_);
+    else if (ext == ".log" || head.starts_with("("))
+        reader_ = std::make_unique<CandumpReader>(std::move(in), source_);
+    else
+        reader_ = std::make_unique<AscReader>(std::move(in), source_);
+
+    // Her dosyanın ilk frame'i hemen oynatılır (dosyalar arası zaman boşluğu beklenmez)
+    haveBase_ = false;
+    return true;
+}
+
+bool ReplayChannel::accepted(const Frame& f) const
+{
+    // SocketCAN ile aynı anlam: olumlu filtrelerden biri VE tüm ters filtreler
+    const uint32_t raw = f.rawId();
+    bool anyPositive = false, hit = false;
+    for (const auto& c : filters_) {
+        if (c.invert) {
+            if (!c.matches(raw)) return false;
+        } else {
+            anyPositive = true;
+            hit = hit || c.matches(raw);
+        }
+    }
+    return !anyPositive || hit;
+}
+
+bool ReplayChannel::next(Frame& out, int64_t& fileUs)
+{
+    while (reader_) {
+        if (reader_->next(out, fileUs)) {
+            if (!accepted(out)) continue;
+            ++passFrames_;
+            return true;
+        }
+
+        // Hiç frame vermeyen tur (boş dosya, hepsi filtrelendi, source uyuşmadı)
+        // yeniden sarılmaz: aksi halde döngü sonsuza dek boşa döner
+        bool opened = false;
+        if (fileIndex_ + 1 < files_.size()) {
+            opened = openFile(fileIndex_ + 1);
+        } else if (loop_ && passFrames_ != 0) {
+            passFrames_ = 0;
+            opened = openFile(0);
+        } else if (loop_) {
+            std::cerr << "[ReplayChannel] Son turda oynatılacak frame yok (boş dosya, filtre ya da source), döngü durduruldu\n";
+        }
+        if (!opened) finish();
+    }
+    return false;
+}
+
+void ReplayChannel::finish()
+{
+    reader_.reset();
+    const double secs = std::chrono::duration<double>(Clock::now() - started_).count();
+    std::cout << "[ReplayChannel] Bitti: " << replayed_ << " frame, " << secs << " sn ("
+              << (secs > 0 ? replayed_ / secs : 0.0) << " fps)" << std::endl;
+    finished_ = true;
+}
+
+bool ReplayChannel::readBatch(std::span<Frame> out, std::size_t& count)
+{
+    count = 0;
+    if (files_.empty()) return false;
+
+    while (count < out.size()) {
+        if (!pending_) {
+            if (!next(pendingFrame_, pendingUs_)) break;
+            pending_ = true;
+        }
+        const auto now = Clock::now();
+        if (!haveBase_) {
+            base_ = now;
+            fileBaseUs_ = pendingUs_;
+            haveBase_ = true;
+        }
+
+        if (speed_ > 0) {
+            const auto offset = std::chrono::microseconds(static_cast<int64_t>((pendingUs_ - fileBaseUs_) / speed_));
+            const auto target = base_ + offset;
+            if (target > now) {
+                if (count != 0) break;                              // hazır olanları teslim et
+                std::this_thread::sleep_until(std::min(target, now + std::chrono::milliseconds(100)));
+                if (target > Clock::now()) return true;             // zaman aşımı
+            }
+            pendingFrame_.ts = std::chrono::duration_cast<std::chrono::microseconds>(target.time_since_epoch());
+        } else {
+            pendingFrame_.ts = std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch());
+        }
+
+        out[count++] = pendingFrame_;
+        pending_ = false;
+        ++replayed_;
+    }
+
+    // Kayıt bitti (ya da dosya yeniden açılamadı): canlı kanal gibi zaman aşımıyla beklemeye devam
+    if (count == 0 && finished_)
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    return true;
+}
+
+bool ReplayChannel::read(Frame& out)
+{
+    std::size_t n = 0;
+    do {
+        if (!readBatch(std::span<Frame>(&out, 1), n)) return false;
+    } while (n == 0);
+    return true;
+}
+
+bool ReplayChannel::setFilters(std::span<const CanFilter> filters)
+{
+    // Donanım yok: kabul filtresi okuma sırasında yazılımda uygulanır
+    filters_.assign(filters.begin(), filters.end());
+    return true;
+}
+
+void ReplayChannel::close()
+{
+    reader_.reset();
+    files_.clear();
+    pending_ = false;
+    haveBase_ = false;
+    finished_ = false;
+    replayed_ = 0;
+    passFrames_ = 0;
+}
+
+} // namespace canmqtt::bus
@@ -4,27 +4,48 @@
 #ifdef __linux__
 #include <linux/can.h>
 #include <linux/can/raw.h>
+#include <linux/net_tstamp.h>
 #include <net/if.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <unistd.h>
 #include <thread>
 #include <climits>
+#include <ctime>
 #endif
+#include <cerrno>
 #include <cstring>
 #include <iostream>
 #include <sstream>
-#include <absl/base/no_destructor.h>  
+#include <vector>
 
 namespace canmqtt::bus {
 
-SocketCanChannel& SocketCanChannel::getInstance(){
-    static absl::NoDestructor<SocketCanChannel> instance;
+#ifdef __linux__
+namespace {
+
+int64_t toNs(const timespec& t) { return int64_t(t.tv_sec) * 1'000'000'000 + t.tv_nsec; }
+
+int64_t clockNs(clockid_t id) {
+    timespec t{};
+    ::clock_gettime(id, &t);
+    return toNs(t);
+}
 
-    return *instance;
+// Kernel/donanım zaman damgası CLOCK_REALTIME (yazılım) ya da sürücüye göre
+// CLOCK_MONOTONIC tabanlı (örn. peak_usb donanım) olabilir. Hangisine yakınsa
+// o saat alanında kabul edip steady_clock (CLOCK_MONOTONIC) eksenine taşırız.
+std::chrono::microseconds toSteady(int64_t stamp_ns, int64_t real_ns, int64_t mono_ns) {
+    const int64_t d_real = stamp_ns > real_ns ? stamp_ns - real_ns : real_ns - stamp_ns;
+    const int64_t d_mono = stamp_ns > mono_ns ? stamp_ns - mono_ns : mono_ns - stamp_ns;
+    const int64_t ns = d_mono < d_real ? stamp_ns : stamp_ns - (real_ns - mono_ns);
+    return std::chrono::microseconds(ns / 1000);
 }
 
-bool SocketCanChannel::open(std::string_view ifname, bool /*fd_mode*/) {
+} // namespace
+#endif
+
+bool SocketCanChannel::open(std::string_view ifname, bool fd_mode) {
 #ifndef __linux__
     std::cerr << "[SocketCanChannel] SocketCAN sadece Linux'ta desteklenir.\n";
     return false;
@@ -49,6 +70,19 @@ bool SocketCanChannel::open(std::string_view ifname, bool /*fd_mode*/) {
     return false;
     }
 
+    // CAN FD: soket hem CAN_MTU hem CANFD_MTU frame teslim eder
+    fdMode_ = false;
+    if (fd_mode) {
+        int enable_fd = 1;
+        if (::setsockopt(fd_, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &enable_fd, sizeof(enable_fd)) < 0) {
+            std::cerr << "[SocketCanChannel] CAN_RAW_FD_FRAMES desteklenmiyor: " << strerror(errno) << "\n";
+            ::close(fd_);
+            fd_ = -1;
+            return false;
+        }
+        fdMode_ = true;
+    }
+
     sockaddr_can addr{AF_CAN, ifr.ifr_ifindex};
 
     if (::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
@@ -57,7 +91,34 @@ bool SocketCanChannel::open(std::string_view ifname, bool /*fd_mode*/) {
         return false;
     }
 
-    std::cout << "[SocketCanChannel] " << ifname << " CAN Interface opened.\n" << std::endl;
+    // Zaman damgası: önce donanım + kernel (SO_TIMESTAMPING), olmazsa kernel ns (SO_TIMESTAMPNS)
+    int ts_flags = SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE |
+                   SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    if (::setsockopt(fd_, SOL_SOCKET, SO_TIMESTAMPING, &ts_flags, sizeof(ts_flags)) < 0) {
+        int on = 1;
+        if (::setsockopt(fd_, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) < 0)
+            std::cerr << "[SocketCanChannel] Kernel timestamp kapalı: " << strerror(errno) << "\n";
+    }
+
+    // Soket kuyruğu taşmalarını (drop sayacı) her mesajla birlikte al
+    int ovfl = 1;
+    if (::setsockopt(fd_, SOL_SOCKET, SO_RXQ_OVFL, &ovfl, sizeof(ovfl)) < 0)
+        std::cerr << "[SocketCanChannel] SO_RXQ_OVFL desteklenmiyor: " << strerror(errno) << "\n";
+
+    // Boş hatta okuyucu sonsuza kadar bloklanmasın; periyodik işler için geri döner
+    timeval tv{0, 100'000};
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    // recvmmsg başlıkları sabit: tamponlara bir kez bağla
+    for (std::size_t i = 0; i < kMaxBatch; ++i) {
+        iov_[i].iov_base = &rx_[i].frame;
+        iov_[i].iov_len  = sizeof(rx_[i].frame);
+        msgs_[i].msg_hdr.msg_iov    = &iov_[i];
+        msgs_[i].msg_hdr.msg_iovlen = 1;
+    }
+    dropped_ = 0;
+
+    std::cout << "[SocketCanChannel] " << ifname << (fdMode_ ? " CAN FD" : " CAN") << " Interface opened.\n" << std::endl;
     return true;  
 #endif
 
@@ -67,12 +128,120 @@ bool SocketCanChannel::read(Frame& out) {
 #ifndef __linux__
     (void)out; return false;
 #else
-    can_frame raw_frame{};
-    ssize_t n = ::recv(fd_, &raw_frame, sizeof(raw_frame), 0);
-    if (n != sizeof(raw_frame)) return false;
-    out.id = raw_frame.can_id;
-    out.data.assign(raw_frame.data, raw_frame.data + raw_frame.can_dlc);
-    out.ts = std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now().time_since_epoch());
+    std::size_t n = 0;
+    do {
+        if (!readBatch(std::span<Frame>(&out, 1), n)) return false;
+    } while (n == 0);
+    return true;
+#endif
+}
+
+bool SocketCanChannel::setFilters(std::span<const CanFilter> filters) {
+#ifndef __linux__
+    (void)filters; return false;
+#else
+    if (fd_ < 0 || filters.size() > kMaxFilters) return false;
+
+    std::vector<can_filter> kf;
+    kf.reserve(filters.size());
+    bool inverted = false;
+    for (const auto& f : filters) {
+        can_filter c{};
+        c.can_id   = f.id | (f.invert ? CAN_INV_FILTER : 0);
+        c.can_mask = f.mask;
+        inverted  |= f.invert;
+        kf.push_back(c);
+    }
+
+    // Ters filtreler "hiçbiri değil" anlamına gelsin diye VE ile birleştirilir;
+    // önceki yüklemeden kalan birleştirme olumlu listede kapatılır (yoksa liste VE'lenir)
+    int join = inverted ? 1 : 0;
+    if (::setsockopt(fd_, SOL_CAN_RAW, CAN_RAW_JOIN_FILTERS, &join, sizeof(join)) < 0 && inverted) {
+        std::cerr << "[SocketCanChannel] CAN_RAW_JOIN_FILTERS desteklenmiyor: " << strerror(errno) << "\n";
+        return false;
+    }
+
+    if (::setsockopt(fd_, SOL_CAN_RAW, CAN_RAW_FILTER, kf.data(),
+                     static_cast<socklen_t>(kf.size() * sizeof(can_filter))) < 0) {
+        std::cerr << "[SocketCanChannel] CAN_RAW_FILTER başarısız: " << strerror(errno) << "\n";
+        return false;
+    }
+    return true;
+#endif
+}
+
+bool SocketCanChannel::readBatch(std::span<Frame> out, std::size_t& count) {
+    count = 0;
+#ifndef __linux__
+    (void)out; return false;
+#else
+    if (fd_ == -1) return false;
+    const unsigned int want = static_cast<unsigned int>(std::min(out.size(), kMaxBatch));
+    if (want == 0) return true;
+
+    for (unsigned int i = 0; i < want; ++i) {
+        msgs_[i].msg_hdr.msg_control    = rx_[i].control;
+        msgs_[i].msg_hdr.msg_controllen = sizeof(rx_[i].control);
+        msgs_[i].msg_hdr.msg_flags      = 0;
+    }
+
+    // MSG_WAITFORONE: ilk frame için bekle, ardından kuyrukta ne varsa bloklamadan topla
+    int n = ::recvmmsg(fd_, msgs_.data(), want, MSG_WAITFORONE, nullptr);
+    if (n < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return true;
+        std::cerr << "[SocketCanChannel] recvmmsg failed: " << strerror(errno) << "\n";
+        return false;
+    }
+
+    // Saat ofsetini batch başına bir kez ölç
+    const int64_t real_ns = clockNs(CLOCK_REALTIME);
+    const int64_t mono_ns = clockNs(CLOCK_MONOTONIC);
+
+    for (int i = 0; i < n; ++i) {
+        const bool is_fd = msgs_[i].msg_len == CANFD_MTU;
+        if (msgs_[i].msg_len != CAN_MTU && !is_fd) continue;
+        const canfd_frame& raw_frame = rx_[i].frame;
+
+        int64_t stamp_ns = 0;
+        for (cmsghdr* c = CMSG_FIRSTHDR(&msgs_[i].msg_hdr); c; c = CMSG_NXTHDR(&msgs_[i].msg_hdr, c)) {
+            if (c->cmsg_level != SOL_SOCKET) continue;
+            if (c->cmsg_type == SO_TIMESTAMPING) {
+                timespec ts[3];
+                std::memcpy(ts, CMSG_DATA(c), sizeof(ts));
+                stamp_ns = toNs(ts[2]) != 0 ? toNs(ts[2]) : toNs(ts[0]); // [2]=raw hw, [0]=sw
+            } else if (c->cmsg_type == SO_TIMESTAMPNS) {
+                timespec ts;
+                std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+                stamp_ns = toNs(ts);
+            } else if (c->cmsg_type == SO_RXQ_OVFL) {
+                uint32_t drops = 0;
+                std::memcpy(&drops, CMSG_DATA(c), sizeof(drops));
+                dropped_ = drops;
+            }
+        }
+
+        Frame& f = out[count++];
+        f.flags = 0;
+        if (raw_frame.can_id & CAN_EFF_FLAG) f.flags |= Frame::kExt;
+        if (raw_frame.can_id & CAN_RTR_FLAG) f.flags |= Frame::kRtr;
+        if (raw_frame.can_id & CAN_ERR_FLAG) f.flags |= Frame::kErr;
+        f.id  = raw_frame.can_id & ((f.flags & Frame::kExt) ? CAN_EFF_MASK : CAN_SFF_MASK);
+        if (is_fd) {
+            f.flags |= Frame::kFd;
+            if (raw_frame.flags & CANFD_BRS) f.flags |= Frame::kBrs;
+            if (raw_frame.flags & CANFD_ESI) f.flags |= Frame::kEsi;
+            f.len = std::min<uint8_t>(raw_frame.len, CANFD_MAX_DLEN);
+            std::memcpy(f.data, raw_frame.data, CANFD_MAX_DLEN);
+        } else {
+            f.len = std::min<uint8_t>(raw_frame.len, CAN_MAX_DLEN);
+            std::memcpy(f.data, raw_frame.data, CAN_MAX_DLEN);
+        }
+        if (f.len < CAN_MAX_DLEN) std::memset(f.data + f.len, 0, CAN_MAX_DLEN - f.len);
+        f.channel = 0;
+        f.ts = stamp_ns != 0
+             ? toSteady(stamp_ns, real_ns, mono_ns)
+             : std::chrono::microseconds(mono_ns / 1000);
+    }
     return true;
 #endif
 }
@@ -80,6 +249,7 @@ bool SocketCanChannel::read(Frame& out) {
 void SocketCanChannel::close() {
 #ifdef __linux__
     if (fd_ != -1) { ::close(fd_); fd_ = -1; }
+    fdMode_ = false;
 #endif
 }
 
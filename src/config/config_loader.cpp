@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <mutex>
 #include <sstream>
 #include <absl/base/no_destructor.h>  
 
@@ -25,6 +26,7 @@ bool ConfigLoader::Load(const std::string& path) {
       std::cout << "[ConfigLoader] Config file opened successfully: " << path << '\n';
   }
 
+  std::unordered_map<std::string, std::unordered_map<std::string, std::string>> table;
   std::string line, section;
   while (std::getline(in, line)) {
     if (line.empty() || line[0] == ';' || line[0] == '#') continue;
@@ -36,15 +38,29 @@ bool ConfigLoader::Load(const std::string& path) {
     if (pos == std::string::npos) continue;
     std::string key = line.substr(0, pos);
     std::string val = line.substr(pos + 1);
-    table_[section][key] = val;
+    table[section][key] = val;
   }
+
+  std::unique_lock lock(mutex_);
+  table_ = std::move(table);
+  path_ = path;
   return true;
 }
 
+bool ConfigLoader::Reload() {
+  const std::string path = Path();
+  return !path.empty() && Load(path);
+}
+
+std::string ConfigLoader::Path() const {
+  std::shared_lock lock(mutex_);
+  return path_;
+}
+
 std::string ConfigLoader::Get(const std::string& section,
                                      const std::string& key,
                                      const std::string& def) const {
-
+  std::shared_lock lock(mutex_);
   auto s_it = table_.find(section);
   if (s_it == table_.end()) return def;
 
@@ -54,4 +70,11 @@ std::string ConfigLoader::Get(const std::string& section,
   return k_it->second;
 }
 
+std::unordered_map<std::string, std::string> ConfigLoader::Section(const std::string& section) const {
+  std::shared_lock lock(mutex_);
+  auto s_it = table_.find(section);
+  if (s_it == table_.end()) return {};
+  return s_it->second;
+}
+
 }  // namespace canmqtt::config
@@ -0,0 +1,270 @@
+#include "dbc/dbc_cache.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <span>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace canmqtt::dbc {
+
+namespace {
+
+constexpr char kMagic[8] = {'V', 'C', 'A', 'N', 'D', 'B', 'C', '\0'};
+
+/* Bölümler: mesaj kayıtları, DecodePlan sütunları (aynı sırayla), isimler */
+enum Section : uint32_t {
+    kMessages, kByteOff, kShift, kBitSize, kFlags, kStartBit, kMask,
+    kFactor, kOffset, kMuxValue, kMinimum, kMaximum, kNames, kStrings,
+    kSectionCount
+};
+
+struct Header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t fingerprint;                ///< DBC içeriğinin FNV-1a 64 özeti
+    uint64_t fileSize;
+    uint32_t messageCount;
+    uint32_t signalCount;
+    uint64_t offset[kSectionCount];      ///< dosya başından, 8 bayt hizalı
+};
+
+struct MessageRecord {
+    uint32_t id;
+    uint32_t size;
+    uint32_t firstSignal;
+    uint32_t signalCount;
+    int32_t  muxSignal;
+    uint32_t nameOff;                    ///< kStrings içinde
+    uint32_t nameLen;
+    uint8_t  extended;
+    uint8_t  reserved[3];
+};
+
+struct StringRef {
+    uint32_t off;
+    uint32_t len;
+};
+
+static_assert(sizeof(Header) == 40 + 8 * kSectionCount);
+static_assert(sizeof(MessageRecord) == 32);
+
+/* Salt okunur dosya görüntüsü: POSIX'te mmap, Windows'ta belleğe okunur */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path)
+    {
+#ifdef _WIN32
+        std::ifstream ifs(path, std::ios::binary);
+        if (ifs) buf_.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+        data_ = buf_.data();
+        size_ = buf_.size();
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return;
+        struct stat st {};
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                data_ = static_cast<const char*>(p);
+                size_ = static_cast<std::size_t>(st.st_size);
+            }
+        }
+        ::close(fd);
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifndef _WIN32
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+    }
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    const char* data_ {nullptr};
+    std::size_t size_ {0};
+#ifdef _WIN32
+    std::vector<char> buf_;
+#endif
+};
+
+/* Bölüm sınırları ve hizası doğrulanmış tipli görünüm; hatalıysa boş */
+template <class T>
+std::span<const T> section(const MappedFile& f, const Header& h, Section s, std::size_t count)
+{
+    const uint64_t off = h.offset[s];
+    if (off % alignof(T) != 0 || off > f.size() || (f.size() - off) / sizeof(T) < count)
+        return {};
+    return {reinterpret_cast<const T*>(f.data() + off), count};
+}
+
+template <class T>
+bool column(const MappedFile& f, const Header& h, Section s, std::vector<T>& out)
+{
+    const auto v = section<T>(f, h, s, h.signalCount);
+    if (v.size() != h.signalCount) return false;
+    out.assign(v.begin(), v.end());
+    return true;
+}
+
+/* Sona hizalı ekleme; bölümün ofsetini döndürür */
+template <class T>
+uint64_t put(std::string& buf, const T* data, std::size_t count)
+{
+    buf.resize((buf.size() + 7) & ~std::size_t{7}, '\0');
+    const uint64_t off = buf.size();
+    buf.append(reinterpret_cast<const char*>(data), count * sizeof(T));
+    return off;
+}
+
+template <class T>
+uint64_t put(std::string& buf, const std::vector<T>& v)
+{
+    return put(buf, v.data(), v.size());
+}
+
+} // namespace
+
+bool DbcCache::read(const std::string& path, uint64_t fingerprint,
+                    std::vector<MessageInfo>& messages, DecodePlan& plan)
+{
+    const MappedFile f(path);
+    if (f.size() < sizeof(Header)) return false;
+
+    Header h;
+    std::memcpy(&h, f.data(), sizeof(h));
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion ||
+        h.headerSize != sizeof(Header) || h.fileSize != f.size())
+        return false;
+    if (h.fingerprint != fingerprint) return false;  // DBC değişmiş: tam ayrıştırma
+
+    const auto recs    = section<MessageRecord>(f, h, kMessages, h.messageCount);
+    const auto names   = section<StringRef>(f, h, kNames, h.signalCount);
+    const uint64_t stringsOff = std::min<uint64_t>(h.offset[kStrings], f.size());
+    const std::span<const char> strings(f.data() + stringsOff, f.size() - stringsOff);
+    if (recs.size() != h.messageCount || names.size() != h.signalCount) return false;
+
+    auto str = [&](uint32_t off, uint32_t len, std::string& out) {
+        if (off > strings.size() || strings.size() - off < len) return false;
+        out.assign(strings.data() + off, len);
+        return true;
+    };
+
+    DecodePlan p;
+    if (!column(f, h, kByteOff, p.byte_off_) || !column(f, h, kShift, p.shift_) ||
+        !column(f, h, kBitSize, p.bit_size_) || !column(f, h, kFlags, p.flags_) ||
+        !column(f, h, kStartBit, p.start_bit_) || !column(f, h, kMask, p.mask_) ||
+        !column(f, h, kFactor, p.factor_) || !column(f, h, kOffset, p.offset_) ||
+        !column(f, h, kMuxValue, p.mux_value_) || !column(f, h, kMinimum, p.minimum_) ||
+        !column(f, h, kMaximum, p.maximum_))
+        return false;
+    p.name_.resize(h.signalCount);
+    for (uint32_t i = 0; i < h.signalCount; ++i)
+        if (!str(names[i].off, names[i].len, p.name_[i])) return false;
+
+    std::vector<MessageInfo> msgs(h.messageCount);
+    for (uint32_t i = 0; i < h.messageCount; ++i) {
+        const MessageRecord& r = recs[i];
+        // Decode sırasında sınır denetimi yok: aralıklar burada bir kez doğrulanır
+        if (r.firstSignal > h.signalCount || h.signalCount - r.firstSignal < r.signalCount ||
+            r.muxSignal >= static_cast<int64_t>(h.signalCount) || r.muxSignal < -1)
+            return false;
+        MessageInfo& m = msgs[i];
+        m.id           = r.id;
+        m.size         = r.size;
+        m.first_signal = r.firstSignal;
+        m.signal_count = r.signalCount;
+        m.mux_signal   = r.muxSignal;
+        m.extended     = r.extended != 0;
+        if (!str(r.nameOff, r.nameLen, m.name)) return false;
+    }
+
+    messages = std::move(msgs);
+    plan = std::move(p);
+    return true;
+}
+
+bool DbcCache::write(const std::string& path, uint64_t fingerprint,
+                     const std::vector<MessageInfo>& messages, const DecodePlan& plan)
+{
+    Header h {};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version      = kVersion;
+    h.headerSize   = sizeof(Header);
+    h.fingerprint  = fingerprint;
+    h.messageCount = static_cast<uint32_t>(messages.size());
+    h.signalCount  = static_cast<uint32_t>(plan.size());
+
+    std::string strings;
+    std::vector<MessageRecord> recs(messages.size());
+    for (std::size_t i = 0; i < messages.size(); ++i) {
+        const MessageInfo& m = messages[i];
+        MessageRecord& r = recs[i];
+        r.id          = m.id;
+        r.size        = m.size;
+        r.firstSignal = m.first_signal;
+        r.signalCount = m.signal_count;
+        r.muxSignal   = m.mux_signal;
+        r.nameOff     = static_cast<uint32_t>(strings.size());
+        r.nameLen     = static_cast<uint32_t>(m.name.size());
+        r.extended    = m.extended ? 1 : 0;
+        strings += m.name;
+    }
+    std::vector<StringRef> names(plan.size());
+    for (std::size_t i = 0; i < plan.size(); ++i) {
+        names[i] = {static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(plan.name_[i].size())};
+        strings += plan.name_[i];
+    }
+
+    std::string buf(sizeof(Header), '\0');
+    h.offset[kMessages] = put(buf, recs);
+    h.offset[kByteOff]  = put(buf, plan.byte_off_);
+    h.offset[kShift]    = put(buf, plan.shift_);
+    h.offset[kBitSize]  = put(buf, plan.bit_size_);
+    h.offset[kFlags]    = put(buf, plan.flags_);
+    h.offset[kStartBit] = put(buf, plan.start_bit_);
+    h.offset[kMask]     = put(buf, plan.mask_);
+    h.offset[kFactor]   = put(buf, plan.factor_);
+    h.offset[kOffset]   = put(buf, plan.offset_);
+    h.offset[kMuxValue] = put(buf, plan.mux_value_);
+    h.offset[kMinimum]  = put(buf, plan.minimum_);
+    h.offset[kMaximum]  = put(buf, plan.maximum_);
+    h.offset[kNames]    = put(buf, names);
+    h.offset[kStrings]  = put(buf, strings.data(), strings.size());
+    h.fileSize = buf.size();
+    std::memcpy(buf.data(), &h, sizeof(h));
+
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream ofs(tmp, std::ios::binary | std::ios::trunc);
+        if (!ofs || !ofs.write(buf.data(), static_cast<std::streamsize>(buf.size())) || !ofs.flush()) {
+            std::cerr << "[DBC] Cache cannot be written: " << tmp << '\n';
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::cerr << "[DBC] Cache cannot be written: " << path << " (" << ec.message() << ")\n";
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace canmqtt::dbc
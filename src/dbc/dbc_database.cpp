@@ -1,11 +1,27 @@
 #include "dbc/dbc_database.hpp"
+#include "dbc/dbc_cache.hpp"
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <sstream>
 #include <cstring>
 #include <absl/base/no_destructor.h>  
 
 namespace canmqtt::dbc {
 
+/* DBC'de 29-bit ID'ler bit31 (EFF) ile saklanır; karşılaştırmalar bayraksız yapılır */
+static constexpr uint32_t kIdMask = 0x1FFFFFFF;
+static uint32_t plainId(uint64_t id) { return static_cast<uint32_t>(id) & kIdMask; }
+
+static uint64_t fnv1a64(std::string_view s)
+{
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (unsigned char c : s) { h ^= c; h *= 0x100000001B3ull; }
+    return h;
+}
+
 DbcDatabase& DbcDatabase::getInstance()
 {
     static absl::NoDestructor<DbcDatabase> instance;
@@ -14,87 +30,207 @@ DbcDatabase& DbcDatabase::getInstance()
 }
 
 /* ───── load ───── */
-bool DbcDatabase::load(const std::string& dbc_file)
+bool DbcDatabase::load(const std::string& dbc_file, const std::string& cache_file)
 {
-    std::ifstream ifs(dbc_file);
+    const auto started = std::chrono::steady_clock::now();
+    std::ifstream ifs(dbc_file, std::ios::binary);
     if (!ifs) 
     {
         std::cerr << "[DBC] File cannot opened: " << dbc_file << '\n';
         return false; 
     } 
 
-    db_ = dbcppp::INetwork::LoadDBCFromIs(ifs);
-    if (!db_)  
+    // İçerik parmak izi: ikili yük şeması (sinyal indeksleri) bu DBC'ye bağlanır
+    std::string text((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    const uint64_t fingerprint = fnv1a64(text);
+
+    // Önbellek aynı içerikten derlendiyse ayrıştırıcı hiç çalışmaz
+    if (!cache_file.empty() && DbcCache::read(cache_file, fingerprint, messages_, plan_)) {
+        db_.reset();
+        fingerprint_ = fingerprint;
+        buildIndex();
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+        std::cout << "[DBC] File has been opened from cache: " << dbc_file
+                  << " (" << messages_.size() << " messages, " << ms.count() << " ms)\n";
+        return true;
+    }
+
+    std::istringstream iss(std::move(text));
+    auto net = dbcppp::INetwork::LoadDBCFromIs(iss);
+    if (!net)  
     {
         std::cerr << "[DBC] Parse failed\n"; return false; 
     }
+    db_ = std::move(net);
+    fingerprint_ = fingerprint;
 
-    std::cout << "[DBC] File has been opened: " << dbc_file << '\n';
+    compile();
+    buildIndex();
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+    std::cout << "[DBC] File has been opened: " << dbc_file
+              << " (" << messages_.size() << " messages, " << ms.count() << " ms)\n";
+
+    if (!cache_file.empty() && DbcCache::write(cache_file, fingerprint_, messages_, plan_))
+        std::cout << "[DBC] Cache has been written: " << cache_file << '\n';
 
     return true;
 }
 
-/* ───── ID → Name (tam → SA’sız → PGN) ───── */
-std::string DbcDatabase::getMessageNameById(uint32_t id) const
+/* ───── index ───── */
+static constexpr uint32_t kNoMessage = 0xFFFFFFFF;
+static constexpr uint64_t kCacheValid = 1ull << 63;
+
+static uint32_t noSaKey(uint32_t id) { return id & 0xFFFFFF00; }
+static uint32_t pgnKey(uint32_t id)  { return (id >> 8) & 0x3FFFF; }
+
+void DbcDatabase::compile()
 {
-    if (!db_) return "";
+    messages_.clear();
+    plan_.clear();
+
+    /* Her mesajın sinyalleri düz decode tablosuna bitişik derlenir */
+    for (const auto& m : db_->Messages()) {
+        MessageInfo info;
+        info.id           = plainId(m.Id());
+        info.extended     = (m.Id() & 0x80000000u) || info.id > 0x7FF;
+        info.name         = m.Name();
+        info.size         = static_cast<uint32_t>(m.MessageSize());
+        info.first_signal = static_cast<uint32_t>(plan_.size());
+        for (const dbcppp::ISignal& s : m.Signals()) {
+            const uint32_t idx = plan_.add(s);
+            if (&s == m.MuxSignal()) info.mux_signal = static_cast<int32_t>(idx);
+        }
+        info.signal_count = static_cast<uint32_t>(plan_.size()) - info.first_signal;
+        messages_.push_back(std::move(info));
+    }
+}
 
-    /* 1) Tam 29-bit ID */
-    for (const auto& m : db_->Messages())
-        if (m.Id() == id) return m.Name();
+/* messages_'tan (ayrıştırma ya da önbellek) arama tabloları */
+void DbcDatabase::buildIndex()
+{
+    maxSignals_ = 0;
+    byId_.clear();
+    byNoSa_.clear();
+    byPgn_.clear();
+    for (const auto& m : messages_)
+        maxSignals_ = std::max<std::size_t>(maxSignals_, m.signal_count);
+
+    byId_.reserve(messages_.size());
+    byNoSa_.reserve(messages_.size());
+    byPgn_.reserve(messages_.size());
+    for (uint32_t i = 0; i < messages_.size(); ++i) {
+        const uint32_t id = messages_[i].id;
+        byId_.try_emplace(id, i);
+        byNoSa_.try_emplace(noSaKey(id), i);
+        byPgn_.try_emplace(pgnKey(id), i);
+    }
 
-    /* 2) SA’sız */
-    uint32_t no_sa = id & 0xFFFFFF00;
-    for (const auto& m : db_->Messages())
-        if ((m.Id() & 0xFFFFFF00) == no_sa) return m.Name();
+    cache_ = std::make_unique<std::atomic<uint64_t>[]>(std::size_t{1} << kCacheBits);
+}
 
-    /* 3) Sadece PGN (18-bit) */
-    uint32_t pgn = (id >> 8) & 0x3FFFF;
-    for (const auto& m : db_->Messages())
-        if (((m.Id() >> 8) & 0x3FFFF) == pgn) return m.Name();
+std::vector<bus::CanFilter> DbcDatabase::acceptanceFilters(const std::vector<bus::CanFilter>& exclude, bool j1939Tp) const
+{
+    std::vector<bus::CanFilter> out;
+    out.reserve(messages_.size() + 2);
+    bool anyExtended = false;
+    for (const auto& m : messages_) {
+        anyExtended |= m.extended;
+        const bus::CanFilter exact = bus::ExactFilter(m.id, m.extended);
+        if (std::any_of(exclude.begin(), exclude.end(),
+                        [&](const bus::CanFilter& x) { return x.matches(exact.id); }))
+            continue;
+        if (m.extended)
+            out.push_back({exact.id & (bus::kJ1939PgnMask | bus::kFilterEff), bus::kJ1939PgnMask | bus::kFilterEff});
+        else
+            out.push_back(exact);
+    }
+    // TP çerçeveleri DBC'deki PGN'i değil taşıma PGN'ini taşır; birleştirme hat işçisinde
+    if (j1939Tp && anyExtended)
+        for (const uint32_t pf : {0xECu, 0xEBu})
+            out.push_back({(pf << 16) | bus::kFilterEff, bus::kJ1939PfMask | bus::kFilterEff});
+    return out;
+}
 
-    return "";
+MessageHandle DbcDatabase::lookup(uint32_t id) const
+{
+    if (auto it = byId_.find(id); it != byId_.end())                 return &messages_[it->second];
+    if (auto it = byNoSa_.find(noSaKey(id)); it != byNoSa_.end())    return &messages_[it->second];
+    if (auto it = byPgn_.find(pgnKey(id)); it != byPgn_.end())       return &messages_[it->second];
+    return nullptr;
+}
+
+/* ───── ID → mesaj (tam → SA’sız → PGN), önbellekli ───── */
+MessageHandle DbcDatabase::resolve(uint32_t id) const
+{
+    if (!cache_) return nullptr;
+    id &= kIdMask;
+
+    auto& slot = cache_[(id * 0x9E3779B1u) >> (32 - kCacheBits)];
+    const uint64_t tag = kCacheValid | (uint64_t(id) << 32);
+    const uint64_t e = slot.load(std::memory_order_relaxed);
+    if ((e & ~uint64_t(0xFFFFFFFF)) == tag) {
+        const uint32_t idx = static_cast<uint32_t>(e);
+        return idx == kNoMessage ? nullptr : &messages_[idx];
+    }
+
+    MessageHandle msg = lookup(id);
+    const uint32_t idx = msg ? static_cast<uint32_t>(msg - messages_.data()) : kNoMessage;
+    slot.store(tag | idx, std::memory_order_relaxed);
+    return msg;
+}
+
+std::string DbcDatabase::getMessageNameById(uint32_t id) const
+{
+    MessageHandle msg = resolve(id);
+    return msg ? msg->name : std::string{};
 }
 
 /* ───── decode ───── */
 bool DbcDatabase::decode(uint32_t id,
-                         const std::vector<uint8_t>& data,
+                         std::span<const uint8_t> data,
                          std::map<std::string,double>& out) const
 {
-    out.clear();
-    if (!db_) return false;
+    return decode(resolve(id), data, out);
+}
 
-    /* Mesajı bul (tam → SA’sız → PGN) */
-    const dbcppp::IMessage* msg = nullptr;
+bool DbcDatabase::decode(MessageHandle handle,
+                         std::span<const uint8_t> data,
+                         DecodedSignals& out) const
+{
+    out.clear();
+    if (!handle) return false;
 
-    for (const auto& m : db_->Messages())
-        if (m.Id() == id) { msg = &m; break; }
+    out.reserve(handle->signal_count); // kararlı durumda no-op
+    out.size_ = plan_.evaluate(handle->first_signal, handle->signal_count,
+                               handle->mux_signal, data,
+                               out.index_.data(), out.value_.data());
+    return !out.empty();
+}
 
-    if (!msg) {
-        uint32_t no_sa = id & 0xFFFFFF00;
-        for (const auto& m : db_->Messages())
-            if ((m.Id() & 0xFFFFFF00) == no_sa) { msg = &m; break; }
-    }
-    if (!msg) {
-        uint32_t pgn = (id >> 8) & 0x3FFFF;
-        for (const auto& m : db_->Messages())
-            if (((m.Id() >> 8) & 0x3FFFF) == pgn) { msg = &m; break; }
-    }
-    if (!msg) return false;
+bool DbcDatabase::decode(MessageHandle handle,
+                         std::span<const uint8_t> data,
+                         std::map<std::string,double>& out) const
+{
+    out.clear();
+    thread_local DecodedSignals sigs;
+    if (!decode(handle, data, sigs)) return false;
 
-    /* 8-bayt buffer (eksik kısımlar 0) */
-    uint8_t buf[8]{0};
-    std::memcpy(buf, data.data(), std::min<size_t>(data.size(), 8));
+    for (std::size_t k = 0; k < sigs.size(); ++k)
+        out[plan_.name(sigs.index(k))] = sigs.value(k);
+    return !out.empty();
+}
 
-    const dbcppp::ISignal* mux = msg->MuxSignal();
-    for (const dbcppp::ISignal& s : msg->Signals()) {
-        if (s.MultiplexerIndicator() == dbcppp::ISignal::EMultiplexer::MuxValue &&
-            mux && mux->Decode(buf) != s.MultiplexerSwitchValue())
-            continue;
+/* ───── encode ───── */
+bool DbcDatabase::encode(MessageHandle handle,
+                         std::span<const double> values,
+                         std::span<uint8_t> out) const
+{
+    if (!handle || values.size() < handle->signal_count || out.size() < handle->size) return false;
 
-        out[s.Name()] = s.RawToPhys( s.Decode(buf) );
-    }
-    return !out.empty();
+    const auto data = out.first(handle->size);
+    std::fill(data.begin(), data.end(), uint8_t{0});
+    plan_.encode(handle->first_signal, handle->signal_count, handle->mux_signal, values.data(), data);
+    return true;
 }
 
 } // namespace dbc
@@ -0,0 +1,287 @@
+#include "dbc/decode_plan.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace canmqtt::dbc {
+
+namespace {
+
+/* Payload sonunu aşan baytlar sıfır okunur: dolgu kopyası gerekmez */
+uint64_t loadLE(std::span<const uint8_t> d, std::size_t off)
+{
+    uint64_t w = 0;
+    if (off + sizeof(w) <= d.size())
+        std::memcpy(&w, d.data() + off, sizeof(w));
+    else if (off < d.size())
+        std::memcpy(&w, d.data() + off, d.size() - off);
+    if constexpr (std::endian::native == std::endian::big) w = __builtin_bswap64(w);
+    return w;
+}
+
+uint64_t loadBE(std::span<const uint8_t> d, std::size_t off)
+{
+    uint64_t w = loadLE(d, off);
+    return __builtin_bswap64(w);
+}
+
+/* loadLE'nin tersi: yalnızca payload içine düşen baytlar yazılır */
+void storeLE(std::span<uint8_t> d, std::size_t off, uint64_t w)
+{
+    if constexpr (std::endian::native == std::endian::big) w = __builtin_bswap64(w);
+    if (off < d.size())
+        std::memcpy(d.data() + off, &w, std::min(sizeof(w), d.size() - off));
+}
+
+void storeBE(std::span<uint8_t> d, std::size_t off, uint64_t w)
+{
+    storeLE(d, off, __builtin_bswap64(w));
+}
+
+void setBitAt(std::span<uint8_t> d, uint32_t bit, int v)
+{
+    const uint32_t byte = bit / 8;
+    if (byte >= d.size()) return;
+    const uint8_t m = uint8_t(1u << (bit % 8));
+    d[byte] = v ? uint8_t(d[byte] | m) : uint8_t(d[byte] & ~m);
+}
+
+int bitAt(std::span<const uint8_t> d, uint32_t bit)
+{
+    const uint32_t byte = bit / 8;
+    return byte < d.size() ? (d[byte] >> (bit % 8)) & 1 : 0;
+}
+
+/* out[k] = x[k] * factor[k] + offset[k]; SSE2 / AArch64 NEON ile 2'şerli */
+void scale(double* x, const double* factor, const double* offset, std::size_t n)
+{
+    std::size_t k = 0;
+#if defined(__SSE2__)
+    for (; k + 2 <= n; k += 2) {
+        __m128d v = _mm_loadu_pd(x + k);
+        v = _mm_add_pd(_mm_mul_pd(v, _mm_loadu_pd(factor + k)), _mm_loadu_pd(offset + k));
+        _mm_storeu_pd(x + k, v);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; k + 2 <= n; k += 2) {
+        float64x2_t v = vld1q_f64(x + k);
+        v = vfmaq_f64(vld1q_f64(offset + k), v, vld1q_f64(factor + k));
+        vst1q_f64(x + k, v);
+    }
+#endif
+    for (; k < n; ++k) x[k] = x[k] * factor[k] + offset[k];
+}
+
+} // namespace
+
+void DecodePlan::clear()
+{
+    byte_off_.clear(); shift_.clear(); bit_size_.clear(); flags_.clear();
+    start_bit_.clear(); mask_.clear(); factor_.clear(); offset_.clear();
+    mux_value_.clear(); minimum_.clear(); maximum_.clear(); name_.clear();
+}
+
+void DecodePlan::reserve(std::size_t n)
+{
+    byte_off_.reserve(n); shift_.reserve(n); bit_size_.reserve(n); flags_.reserve(n);
+    start_bit_.reserve(n); mask_.reserve(n); factor_.reserve(n); offset_.reserve(n);
+    mux_value_.reserve(n); minimum_.reserve(n); maximum_.reserve(n); name_.reserve(n);
+}
+
+uint32_t DecodePlan::add(const dbcppp::ISignal& s)
+{
+    using S = dbcppp::ISignal;
+    const uint32_t idx   = static_cast<uint32_t>(size());
+    const uint32_t start = static_cast<uint32_t>(s.StartBit());
+    const uint32_t bits  = static_cast<uint32_t>(s.BitSize());
+
+    uint8_t flags = 0;
+    if (s.ByteOrder() == S::EByteOrder::BigEndian)                 flags |= kBigEndian;
+    if (s.ValueType() == S::EValueType::Signed)                    flags |= kSigned;
+    if (s.ExtendedValueType() == S::EExtendedValueType::Float)     flags |= kFloat;
+    if (s.ExtendedValueType() == S::EExtendedValueType::Double)    flags |= kDouble;
+    if (s.MultiplexerIndicator() == S::EMultiplexer::MuxValue)     flags |= kMuxed;
+
+    /* Alanı tek 64-bit yüklemeyle okunacak (bayt, kaydırma) çiftine indirge.
+       Motorola start bit'i MSB'yi gösterir: önce doğrusal big-endian bit
+       numarasına çevrilir (bayt0'ın MSB'si = 0). */
+    uint32_t byte_off = 0;
+    int shift = 0;
+    if (flags & kBigEndian) {
+        const uint32_t msb = (start / 8) * 8 + (7 - start % 8);
+        byte_off = msb / 8;
+        shift    = 64 - int(msb % 8) - int(bits);
+    } else {
+        byte_off = start / 8;
+        shift    = int(start % 8);
+        if (shift + int(bits) > 64) shift = -1;
+    }
+    if (shift < 0 || bits == 0 || bits > 64) { flags |= kSlow; shift = 0; }
+
+    byte_off_.push_back(static_cast<uint16_t>(byte_off));
+    shift_.push_back(static_cast<uint8_t>(shift));
+    bit_size_.push_back(static_cast<uint8_t>(bits));
+    flags_.push_back(flags);
+    start_bit_.push_back(static_cast<uint16_t>(start));
+    mask_.push_back(bits >= 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1);
+    factor_.push_back(s.Factor());
+    offset_.push_back(s.Offset());
+    mux_value_.push_back(s.MultiplexerSwitchValue());
+    minimum_.push_back(s.Minimum());
+    maximum_.push_back(s.Maximum());
+    name_.push_back(s.Name());
+    return idx;
+}
+
+uint64_t DecodePlan::extractSlow(uint32_t i, std::span<const uint8_t> data) const
+{
+    const uint32_t bits = bit_size_[i];
+    uint32_t bit = start_bit_[i];
+    uint64_t v = 0;
+    if (flags_[i] & kBigEndian) {
+        /* MSB'den başlayıp DBC "sawtooth" sırasında ilerle */
+        for (uint32_t k = 0; k < bits; ++k) {
+            v = (v << 1) | uint64_t(bitAt(data, bit));
+            bit = (bit % 8 == 0) ? bit + 15 : bit - 1;
+        }
+    } else {
+        for (uint32_t k = 0; k < bits; ++k)
+            v |= uint64_t(bitAt(data, bit + k)) << k;
+    }
+    return v;
+}
+
+uint64_t DecodePlan::extractRaw(uint32_t i, std::span<const uint8_t> data) const
+{
+    if (flags_[i] & kSlow) return extractSlow(i, data);
+    const uint64_t w = (flags_[i] & kBigEndian) ? loadBE(data, byte_off_[i])
+                                                : loadLE(data, byte_off_[i]);
+    return (w >> shift_[i]) & mask_[i];
+}
+
+double DecodePlan::extractValue(uint32_t i, std::span<const uint8_t> data) const
+{
+    const uint64_t raw = extractRaw(i, data);
+    const uint8_t f = flags_[i];
+    if (f & kFloat)  return std::bit_cast<float>(static_cast<uint32_t>(raw));
+    if (f & kDouble) return std::bit_cast<double>(raw);
+    if ((f & kSigned) && bit_size_[i] < 64) {
+        const int sh = 64 - bit_size_[i];
+        return double(static_cast<int64_t>(raw << sh) >> sh);
+    }
+    if (f & kSigned) return double(static_cast<int64_t>(raw));
+    return double(raw);
+}
+
+std::size_t DecodePlan::evaluate(uint32_t first, uint32_t count, int32_t mux,
+                                 std::span<const uint8_t> data,
+                                 uint32_t* out_idx, double* out_val) const
+{
+    /* Mux switch bir kez okunur */
+    const uint64_t mux_raw = mux >= 0 ? extractRaw(static_cast<uint32_t>(mux), data) : 0;
+
+    std::size_t n = 0;
+    for (uint32_t i = first; i < first + count; ++i) {
+        if ((flags_[i] & kMuxed) && mux >= 0 && mux_value_[i] != mux_raw) continue;
+        out_idx[n] = i;
+        out_val[n] = extractValue(i, data);
+        ++n;
+    }
+
+    /* Ölçekleme: atlanan sinyal yoksa sütunlar bitişik → vektörel yol */
+    if (n == count)
+        scale(out_val, factor_.data() + first, offset_.data() + first, n);
+    else
+        for (std::size_t k = 0; k < n; ++k)
+            out_val[k] = out_val[k] * factor_[out_idx[k]] + offset_[out_idx[k]];
+    return n;
+}
+
+/* ───── encode ───── */
+
+uint64_t DecodePlan::toRaw(uint32_t i, double value) const
+{
+    const uint8_t f = flags_[i];
+    const double x = factor_[i] != 0.0 ? (value - offset_[i]) / factor_[i] : 0.0;
+    if (f & kFloat)  return std::bit_cast<uint32_t>(static_cast<float>(x));
+    if (f & kDouble) return std::bit_cast<uint64_t>(x);
+
+    const int bits = bit_size_[i];
+    const double r = std::nearbyint(x);
+    if (f & kSigned) {
+        const double lo = -std::ldexp(1.0, bits - 1);
+        const double hi =  std::ldexp(1.0, bits - 1) - 1.0;
+        const int64_t v = r <= lo ? static_cast<int64_t>(lo)
+                        : r >= hi ? (bits >= 64 ? INT64_MAX : static_cast<int64_t>(hi))
+                                  : static_cast<int64_t>(r);
+        return static_cast<uint64_t>(v) & mask_[i];
+    }
+    if (!(r > 0.0)) return 0;                                   // NaN dahil
+    if (r >= std::ldexp(1.0, bits)) return mask_[i];
+    return static_cast<uint64_t>(r) & mask_[i];
+}
+
+void DecodePlan::insertSlow(uint32_t i, uint64_t raw, std::span<uint8_t> data) const
+{
+    const uint32_t bits = bit_size_[i];
+    uint32_t bit = start_bit_[i];
+    if (flags_[i] & kBigEndian) {
+        for (uint32_t k = 0; k < bits; ++k) {
+            setBitAt(data, bit, int((raw >> (bits - 1 - k)) & 1));
+            bit = (bit % 8 == 0) ? bit + 15 : bit - 1;
+        }
+    } else {
+        for (uint32_t k = 0; k < bits; ++k)
+            setBitAt(data, bit + k, int((raw >> k) & 1));
+    }
+}
+
+void DecodePlan::insertRaw(uint32_t i, uint64_t raw, std::span<uint8_t> data) const
+{
+    if (flags_[i] & kSlow) { insertSlow(i, raw, data); return; }
+    const uint64_t field = mask_[i] << shift_[i];
+    const uint64_t bits  = (raw & mask_[i]) << shift_[i];
+    if (flags_[i] & kBigEndian) {
+        const uint64_t w = loadBE(data, byte_off_[i]);
+        storeBE(data, byte_off_[i], (w & ~field) | bits);
+    } else {
+        const uint64_t w = loadLE(data, byte_off_[i]);
+        storeLE(data, byte_off_[i], (w & ~field) | bits);
+    }
+}
+
+void DecodePlan::encode(uint32_t first, uint32_t count, int32_t mux,
+                        const double* values, std::span<uint8_t> data) const
+{
+    const uint64_t mux_raw = mux >= 0 ? toRaw(static_cast<uint32_t>(mux), values[static_cast<uint32_t>(mux) - first]) : 0;
+    for (uint32_t i = first; i < first + count; ++i) {
+        if ((flags_[i] & kMuxed) && mux >= 0 && mux_value_[i] != mux_raw) continue;
+        insertRaw(i, toRaw(i, values[i - first]), data);
+    }
+}
+
+std::pair<double, double> DecodePlan::range(uint32_t i) const
+{
+    if (minimum_[i] < maximum_[i]) return {minimum_[i], maximum_[i]};
+
+    // Tanımsız: ham alanın uçları (çok geniş alanlar 32 bite sınırlanır)
+    const uint8_t f = flags_[i];
+    const int bits = std::min<int>(bit_size_[i], 32);
+    double lo = 0.0, hi = std::ldexp(1.0, bits) - 1.0;
+    if ((f & kSigned) || (f & (kFloat | kDouble))) {
+        lo = -std::ldexp(1.0, bits - 1);
+        hi =  std::ldexp(1.0, bits - 1) - 1.0;
+    }
+    lo = lo * factor_[i] + offset_[i];
+    hi = hi * factor_[i] + offset_[i];
+    return lo <= hi ? std::pair{lo, hi} : std::pair{hi, lo};
+}
+
+} // namespace canmqtt::dbc
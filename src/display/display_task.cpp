@@ -1,22 +1,115 @@
 #include "task/display_task.hpp"
+#include "task/signal_history.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
+#include <string>
 #include <thread>
+#include <vector>
+
+#include <fmt/core.h>
 
 #include "config/config_loader.hpp"
 
 namespace canmqtt::task {
 
+namespace {
+
+// [display] signals girdisi: "[bus/]Mesaj.Sinyal"
+struct Watch {
+  std::string bus, message, signal;
+  SignalHistory::Series series {SignalHistory::kNone};
+};
+
+std::vector<Watch> ParseWatches(const std::string &text) {
+  std::vector<Watch> out;
+  std::size_t pos = 0;
+  while (pos <= text.size()) {
+    std::size_t comma = text.find(',', pos);
+    if (comma == std::string::npos) comma = text.size();
+    std::string item = text.substr(pos, comma - pos);
+    pos = comma + 1;
+    item.erase(0, item.find_first_not_of(" \t"));
+    item.erase(item.find_last_not_of(" \t\r") + 1);
+    if (item.empty()) continue;
+
+    Watch w;
+    if (auto slash = item.find('/'); slash != std::string::npos) {
+      w.bus = item.substr(0, slash);
+      item.erase(0, slash + 1);
+    }
+    const auto dot = item.find('.');
+    if (dot == std::string::npos) {
+      std::cerr << "[Display] Mesaj.Sinyal bekleniyordu, atlandı: " << item << "\n";
+      continue;
+    }
+    w.message = item.substr(0, dot);
+    w.signal = item.substr(dot + 1);
+    out.push_back(std::move(w));
+  }
+  return out;
+}
+
+// Kova ortalamalarından tek satırlık grafik; boş kovalar boşluk
+std::string Sparkline(const std::vector<SignalHistory::Bucket> &buckets, std::chrono::microseconds from,
+                      std::chrono::microseconds span, std::size_t width, double lo, double hi) {
+  static constexpr const char *kLevels[] = {"▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+  std::vector<int> level(width, -1);
+  for (const auto &b : buckets) {
+    const auto k = std::min<std::size_t>(width - 1, static_cast<std::size_t>((b.start - from).count() * width / (span.count() + 1)));
+    const double norm = hi > lo ? (b.mean - lo) / (hi - lo) : 0.5;
+    level[k] = std::clamp(static_cast<int>(norm * 7.0 + 0.5), 0, 7);
+  }
+  std::string line;
+  for (int l : level) line += l < 0 ? " " : kLevels[l];
+  return line;
+}
+
+}  // namespace
+
 void StartDisplay() {
   using namespace std::chrono_literals;
-  int interval_ms = std::stoi(
-                              canmqtt::config::ConfigLoader::getInstance().Get("os",
-                                                                            "display_task_interval_ms",
-                                                                            ""));
-  std::jthread{[interval_ms] {
+  auto &cl = canmqtt::config::ConfigLoader::getInstance();
+  int interval_ms = cl.GetNumber("os", "display_task_interval_ms", 250);
+
+  // Değerler MQTT'den değil süreç içi geçmişten ([history]) okunur
+  auto &history = SignalHistory::getInstance();
+  std::vector<Watch> watches = ParseWatches(cl.Get("display", "signals", ""));
+  if (watches.empty()) return;
+  if (!history.enabled()) {
+    std::cerr << "[Display] [history] enable=0, ekran görevi başlatılmadı\n";
+    return;
+  }
+  const std::chrono::microseconds window = std::chrono::seconds(cl.GetNumber("display", "window_s", 10));
+  const std::size_t width = std::max<std::size_t>(8, cl.GetNumber<std::size_t>("display", "width", 48));
+
+  std::jthread{[interval_ms, watches = std::move(watches), window, width, &history]() mutable {
+    std::vector<SignalHistory::Bucket> buckets;
     while (true) {
       std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+      const auto now = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now().time_since_epoch());
+      std::string out;
+      for (auto &w : watches) {
+        // Sinyal ilk kez görülene kadar seri yoktur
+        if (w.series == SignalHistory::kNone) w.series = history.find(w.bus, w.message, w.signal);
+        if (w.series == SignalHistory::kNone) continue;
+        if (history.downsample(w.series, now - window, now, width, buckets) == 0) continue;
+
+        double lo = buckets.front().min, hi = buckets.front().max;
+        uint64_t count = 0;
+        for (const auto &b : buckets) {
+          lo = std::min(lo, b.min);
+          hi = std::max(hi, b.max);
+          count += b.count;
+        }
+        out += fmt::format("[Display] {}{}{}.{} |{}| son {:g} (min {:g}, max {:g}, {} örnek)\n",
+                           w.bus, w.bus.empty() ? "" : "/", w.message, w.signal,
+                           Sparkline(buckets, now - window, window, width, lo, hi),
+                           buckets.back().last, lo, hi, count);
+      }
+      if (!out.empty()) std::cout << out << std::flush;
     }
   }}.detach();
 }
@@ -11,7 +11,7 @@ int main() {
   V_INIT_TASK();
   V_LISTENER_TASK();
   V_PERIODIC_TASK();
-  /*V_DISPLAY_TASK();*/
+  V_DISPLAY_TASK();
   std::cout << "Initialization scheduled. Waiting for CAN frames / MQTT..." << std::endl;
   while (true) std::this_thread::sleep_for(std::chrono::hours(24));
   return 0;
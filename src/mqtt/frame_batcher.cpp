@@ -0,0 +1,99 @@
+#include "mqtt/frame_batcher.hpp"
+#include "mqtt/mqtt_publisher.hpp"
+#include "util/frame_serializer.hpp"
+#include "util/binary_serializer.hpp"
+
+#include <algorithm>
+
+namespace canmqtt::mqtt
+{
+
+    FrameBatcher::FrameBatcher(std::string busName,
+                               std::chrono::milliseconds window,
+                               std::size_t maxFrames,
+                               PayloadFormat format,
+                               uint64_t fingerprint,
+                               uint16_t stream)
+        : busName_(std::move(busName)),
+          topic_("can/" + busName_ + "/batch"),
+          window_(window),
+          // İkili başlıktaki sayı u16: daha büyük sınır birden çok batch'e bölünür
+          maxFrames_(std::clamp<std::size_t>(maxFrames, 1, format == PayloadFormat::Binary ? util::binary::kMaxBatchFrames
+                                                                                          : ~std::size_t{0})),
+          format_(format),
+          fingerprint_(fingerprint),
+          stream_(stream)
+    {
+        body_.reserve(64 * 1024);
+        out_.reserve(64 * 1024);
+    }
+
+    std::string& FrameBatcher::next()
+    {
+        recordStart_ = body_.size();
+        if (format_ == PayloadFormat::Binary)
+        {
+            body_.append(2, '\0');                  // uzunluk commit()'te yazılır
+        }
+        else if (count_ != 0)
+        {
+            body_ += ',';
+        }
+        return body_;
+    }
+
+    bool FrameBatcher::commit(std::chrono::steady_clock::time_point now)
+    {
+        if (format_ == PayloadFormat::Binary)
+            util::binary::writeU16(body_, recordStart_,
+                                   static_cast<uint16_t>(body_.size() - recordStart_ - 2));
+        if (count_++ == 0) opened_ = now;
+        return count_ >= maxFrames_;
+    }
+
+    void FrameBatcher::discard()
+    {
+        body_.resize(recordStart_);
+    }
+
+    bool FrameBatcher::due(std::chrono::steady_clock::time_point now) const
+    {
+        return count_ != 0 && now - opened_ >= window_;
+    }
+
+    void FrameBatcher::flush(Publisher& pub, int qos)
+    {
+        if (count_ == 0) return;
+
+        out_.clear();
+        if (format_ == PayloadFormat::Binary)
+        {
+            util::binary::putHeader(out_, util::binary::kKindBatch, fingerprint_);
+            util::binary::putU32(out_, static_cast<uint32_t>(seq_));
+            util::binary::putU16(out_, static_cast<uint16_t>(count_));
+            util::binary::putU16(out_, stream_);
+            out_ += body_;
+        }
+        else
+        {
+            out_ += "{\"seq\":";
+            util::appendNumber(out_, seq_);
+            out_ += ",\"stream\":";
+            util::appendNumber(out_, static_cast<uint64_t>(stream_));
+            out_ += ",\"bus\":\"";
+            util::appendEscaped(out_, busName_);
+            out_ += "\",\"count\":";
+            util::appendNumber(out_, static_cast<uint64_t>(count_));
+            out_ += ",\"frames\":[";
+            out_ += body_;
+            out_ += "]}";
+        }
+
+        pub.Publish(topic_, out_, qos);
+
+        ++seq_;
+        count_ = 0;
+        body_.clear();
+    }
+
+} // namespace canmqtt::mqtt
@@ -1,8 +1,11 @@
 #include "mqtt/mqtt_publisher.hpp"
+#include <chrono>
 #include <iostream>
 
 namespace canmqtt::mqtt
 {
+    using namespace std::chrono_literals;
+
     Publisher& Publisher::getInstance()
     {
         static absl::NoDestructor<Publisher> instance;
@@ -10,16 +13,41 @@ namespace canmqtt::mqtt
         return *instance;
     }
 
+    OverflowPolicy Publisher::ParsePolicy(const std::string &s)
+    {
+        if (s == "drop_newest") return OverflowPolicy::DropNewest;
+        if (s == "block")       return OverflowPolicy::Block;
+        return OverflowPolicy::DropOldest;
+    }
+
     bool Publisher::Init(const std::string &uri,
                          const std::string &client_id,
-                         int keep_alive)
+                         int keep_alive,
+                         const PublisherOptions &opts)
     {
+        opts_ = opts;
+        if (opts_.inflight < 1) opts_.inflight = 1;
+        if (opts_.inflight > kMaxInflight)
+        {
+            std::cerr << "[MQTT] inflight=" << opts_.inflight << " senkron istemcide desteklenmiyor, "
+                      << kMaxInflight << " kullanılıyor\n";
+            opts_.inflight = kMaxInflight;
+        }
+
         MQTTClient_create(&client_, uri.c_str(), client_id.c_str(),
                           MQTTCLIENT_PERSISTENCE_NONE, nullptr);
 
-        MQTTClient_connectOptions opts = MQTTClient_connectOptions_initializer;
-        opts.keepAliveInterval = keep_alive;
-        opts.cleansession = 1;
+        // Callback'ler ayarlanınca paho PUBACK'leri kendi thread'inde işler;
+        // deliveryComplete ile in-flight pencere sayacı azaltılır.
+        MQTTClient_setCallbacks(client_, this, &Publisher::OnConnectionLost,
+                                &Publisher::OnMessageArrived, &Publisher::OnDeliveryComplete);
+
+        connOpts_ = MQTTClient_connectOptions_initializer;
+        connOpts_.keepAliveInterval = keep_alive;
+        connOpts_.cleansession = 1;
+        // reliable=1 (varsayılan) her publish'i bir önceki onaylanana kadar bekletir;
+        // pencere ancak kapalıyken işe yarar (paho: en fazla 10 mesaj)
+        connOpts_.reliable = 0;
 
         /* TLS :
         MQTTClient_SSLOptions ssl_opts = MQTTClient_SSLOptions_initializer;
@@ -27,28 +55,186 @@ namespace canmqtt::mqtt
         opts.ssl = &ssl_opts;
         */
 
-        int rc = MQTTClient_connect(client_, &opts);
+        queue_ = std::make_unique<util::BoundedQueue<OutMsg>>(opts_.queue_size);
+
+        int rc = MQTTClient_connect(client_, &connOpts_);
+        lastReconnect_ = std::chrono::steady_clock::now();
+        // Bağlantı olmasa da gönderici başlar: kuyruğu boşaltır ve yeniden bağlanmayı dener
+        sender_ = std::jthread([this](std::stop_token st) { SenderLoop(st); });
         if (rc != MQTTCLIENT_SUCCESS)
         {
             std::cerr << "MQTT connect failed, rc=" << rc << '\n';
             return false;
         }
-        std::cout << "[MQTT] Connected to " << uri << " as " << client_id << '\n';
+        std::cout << "[MQTT] Connected to " << uri << " as " << client_id
+                  << " (queue=" << queue_->capacity() << ", inflight=" << opts_.inflight << ")\n";
         
         return true;
     }
 
     void Publisher::Publish(const std::string &topic,
                             const std::string &payload,
-                            int qos)
+                            int qos,
+                            bool retained)
     {
+        if (!queue_)
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Slot'taki string'ler yeniden kullanılır: kapasite yetiyorsa kopya heap'siz
+        auto fill = [&](OutMsg &slot) {
+            slot.topic.assign(topic);
+            slot.payload.assign(payload);
+            slot.qos = qos;
+            slot.retained = retained;
+        };
+        auto discard = [](OutMsg &) {};
+
+        while (!queue_->tryPush(fill))
+        {
+            switch (opts_.overflow)
+            {
+                case OverflowPolicy::DropNewest:
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                case OverflowPolicy::DropOldest:
+                    if (queue_->tryPop(discard))
+                        dropped_.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                case OverflowPolicy::Block:
+                    std::this_thread::sleep_for(50us);
+                    break;
+            }
+        }
+        queued_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    PublisherStats Publisher::Stats() const
+    {
+        return PublisherStats{queued_.load(std::memory_order_relaxed),
+                              sent_.load(std::memory_order_relaxed),
+                              dropped_.load(std::memory_order_relaxed),
+                              failed_.load(std::memory_order_relaxed),
+                              stalled_.load(std::memory_order_relaxed)};
+    }
+
+    void Publisher::SenderLoop(std::stop_token st)
+    {
+        OutMsg msg;
+        bool pending = false;   // pencere dolu kaldığı için yeniden denenecek mesaj
+        uint64_t lastDropped = 0, lastStalled = 0;
+        auto lastReport = std::chrono::steady_clock::now();
+
+        while (!st.stop_requested())
+        {
+            // Slot ile yerel tampon takas edilir: ayrılmış kapasite dolaşımda kalır
+            if (!pending && !queue_->tryPop([&](OutMsg &slot) { std::swap(msg, slot); }))
+            {
+                std::this_thread::sleep_for(1ms);
+            }
+            else
+            {
+                switch (Send(msg))
+                {
+                    case SendResult::Sent:
+                        sent_.fetch_add(1, std::memory_order_relaxed);
+                        pending = false;
+                        break;
+                    case SendResult::Failed:
+                        failed_.fetch_add(1, std::memory_order_relaxed);
+                        pending = false;
+                        break;
+                    case SendResult::WindowFull:
+                        // Mesaj atılmaz: kuyruğun başındaymış gibi yeniden denenir,
+                        // bu sırada dolan kuyruk overflow politikasına göre davranır
+                        stalled_.fetch_add(1, std::memory_order_relaxed);
+                        pending = true;
+                        break;
+                }
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (now - lastReport >= 5s)
+            {
+                lastReport = now;
+                const uint64_t d = dropped_.load(std::memory_order_relaxed);
+                const uint64_t w = stalled_.load(std::memory_order_relaxed);
+                if (d != lastDropped || w != lastStalled)
+                {
+                    const auto s = Stats();
+                    std::cerr << "[MQTT] queued=" << s.queued << " sent=" << s.sent
+                              << " dropped=" << s.dropped << " failed=" << s.failed
+                              << " stalled=" << s.stalled << '\n';
+                    lastDropped = d;
+                    lastStalled = w;
+                }
+            }
+        }
+    }
+
+    Publisher::SendResult Publisher::Send(OutMsg &m)
+    {
+        if (!MQTTClient_isConnected(client_) && !Reconnect()) return SendResult::Failed;
+
+        // In-flight pencere dolu ise PUBACK bekle
+        if (m.qos > 0)
+        {
+            auto deadline = std::chrono::steady_clock::now() + 2s;
+            while (inflight_.load(std::memory_order_acquire) >= opts_.inflight)
+            {
+                if (std::chrono::steady_clock::now() > deadline) return SendResult::WindowFull;
+                std::this_thread::sleep_for(100us);
+            }
+        }
+
         MQTTClient_message msg = MQTTClient_message_initializer;
-        msg.payload = const_cast<char *>(payload.data());
-        msg.payloadlen = static_cast<int>(payload.size());
-        msg.qos = qos;
-        msg.retained = 0;
+        msg.payload = const_cast<char *>(m.payload.data());
+        msg.payloadlen = static_cast<int>(m.payload.size());
+        msg.qos = m.qos;
+        msg.retained = m.retained ? 1 : 0;
+
+        if (m.qos > 0) inflight_.fetch_add(1, std::memory_order_acq_rel);
+        int rc = MQTTClient_publishMessage(client_, m.topic.c_str(), &msg, nullptr);
+        if (rc != MQTTCLIENT_SUCCESS)
+        {
+            if (m.qos > 0) inflight_.fetch_sub(1, std::memory_order_acq_rel);
+            return SendResult::Failed;
+        }
+        return SendResult::Sent;
+    }
 
-        MQTTClient_publishMessage(client_, topic.c_str(), &msg, nullptr);
+    bool Publisher::Reconnect()
+    {
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastReconnect_ < 1s) return false;
+        lastReconnect_ = now;
+
+        inflight_.store(0, std::memory_order_release);
+        int rc = MQTTClient_connect(client_, &connOpts_);
+        if (rc != MQTTCLIENT_SUCCESS) return false;
+        std::cout << "[MQTT] Reconnected\n";
+        return true;
+    }
+
+    int Publisher::OnMessageArrived(void *, char *topic, int, MQTTClient_message *msg)
+    {
+        MQTTClient_freeMessage(&msg);
+        MQTTClient_free(topic);
+        return 1;
+    }
+
+    void Publisher::OnDeliveryComplete(void *ctx, MQTTClient_deliveryToken)
+    {
+        auto *self = static_cast<Publisher *>(ctx);
+        if (self->inflight_.fetch_sub(1, std::memory_order_acq_rel) <= 0)
+            self->inflight_.store(0, std::memory_order_release);
+    }
+
+    void Publisher::OnConnectionLost(void *, char *cause)
+    {
+        std::cerr << "[MQTT] Connection lost: " << (cause ? cause : "?") << '\n';
     }
 
 } // namespace canmqtt::mqtt
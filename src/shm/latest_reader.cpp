@@ -0,0 +1,160 @@
+#include "shm/latest_reader.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace canmqtt::shm {
+
+namespace {
+
+// Salt okunur eşlemede yalnızca yükleme yapılır (atomic_ref C++20'de const tür almaz)
+template <class T>
+T load(const T& v, std::memory_order order = std::memory_order_relaxed)
+{
+    return std::atomic_ref<T>(const_cast<T&>(v)).load(order);
+}
+
+} // namespace
+
+LatestReader::~LatestReader()
+{
+    close();
+}
+
+bool LatestReader::open(const std::string& name)
+{
+    close();
+#ifndef _WIN32
+    const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+    struct stat st {};
+    void* base = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= sizeof(Header))
+        base = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) return false;
+    name_ = name;
+    dev_ = static_cast<uint64_t>(st.st_dev);
+    ino_ = static_cast<uint64_t>(st.st_ino);
+    base_ = base;
+    size_ = static_cast<std::size_t>(st.st_size);
+
+    // Yazar sürümü en son yazar; bölümler eşlenen boyutun içinde olmalı
+    const auto* h = static_cast<const Header*>(base);
+    const uint32_t version = load(h->version, std::memory_order_acquire);
+    const bool valid = version == kVersion && std::memcmp(h->magic, kMagic, sizeof(kMagic)) == 0 &&
+                       h->headerSize == sizeof(Header) && h->slotSize == sizeof(Slot) &&
+                       h->sourcesOffset + uint64_t{h->sourceCount} * sizeof(SourceEntry) <= size_ &&
+                       h->slotsOffset % alignof(Slot) == 0 &&
+                       h->slotsOffset + uint64_t{h->slotCount} * sizeof(Slot) <= size_ &&
+                       h->stringsOffset + h->stringsSize <= size_;
+    if (!valid) {
+        close();
+        return false;
+    }
+    header_ = h;
+    sources_ = reinterpret_cast<const SourceEntry*>(static_cast<const char*>(base) + h->sourcesOffset);
+    slots_ = reinterpret_cast<const Slot*>(static_cast<const char*>(base) + h->slotsOffset);
+    return true;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+void LatestReader::close()
+{
+#ifndef _WIN32
+    if (base_) ::munmap(const_cast<void*>(base_), size_);
+#endif
+    name_.clear();
+    dev_ = 0;
+    ino_ = 0;
+    base_ = nullptr;
+    size_ = 0;
+    header_ = nullptr;
+    sources_ = nullptr;
+    slots_ = nullptr;
+}
+
+bool LatestReader::stale() const
+{
+    if (!header_ || load(header_->retired, std::memory_order_acquire) != 0) return true;
+#ifndef _WIN32
+    // Çöken yazar retired yazamaz: süreç yoksa (EPERM: var ama başka kullanıcı) eskidir
+    if (header_->writerPid > 0 && ::kill(static_cast<pid_t>(header_->writerPid), 0) != 0 && errno == ESRCH)
+        return true;
+
+    // Yeniden başlayan yazar adı unlink edip yeni segment açar: ad başka inode'u gösterir
+    const int fd = ::shm_open(name_.c_str(), O_RDONLY, 0);
+    if (fd < 0) return true;
+    struct stat st {};
+    const bool same = ::fstat(fd, &st) == 0 && static_cast<uint64_t>(st.st_dev) == dev_ &&
+                      static_cast<uint64_t>(st.st_ino) == ino_;
+    ::close(fd);
+    return !same;
+#else
+    return false;
+#endif
+}
+
+std::string_view LatestReader::string(uint64_t offset) const
+{
+    if (!header_ || offset >= header_->stringsSize) return {};
+    const char* s = static_cast<const char*>(base_) + header_->stringsOffset + offset;
+    return {s, ::strnlen(s, header_->stringsSize - offset)};
+}
+
+uint32_t LatestReader::find(std::string_view bus, std::string_view message, std::string_view signal) const
+{
+    for (uint32_t i = 0; i < size(); ++i)
+        if ((bus.empty() || this->bus(i) == bus) && this->message(i) == message && this->signal(i) == signal)
+            return i;
+    return kNoSlot;
+}
+
+std::string_view LatestReader::bus(uint32_t slot) const
+{
+    if (slot >= size() || slots_[slot].source >= header_->sourceCount) return {};
+    return string(sources_[slots_[slot].source].busOffset);
+}
+
+std::string_view LatestReader::message(uint32_t slot) const
+{
+    return slot < size() ? string(slots_[slot].messageOffset) : std::string_view{};
+}
+
+std::string_view LatestReader::signal(uint32_t slot) const
+{
+    return slot < size() ? string(slots_[slot].signalOffset) : std::string_view{};
+}
+
+bool LatestReader::read(uint32_t slot, Value& out) const
+{
+    if (slot >= size()) return false;
+    const Slot& s = slots_[slot];
+
+    // Seqlock: tek seq yazımda; önce/sonra aynı çift değer tutarlı kopya demektir.
+    // Yazma birkaç yüz ns sürer; sınır yalnızca yazar süreci yazarken ölürse devreye girer.
+    for (int attempt = 0; attempt < 100000; ++attempt) {
+        const uint32_t before = load(s.seq, std::memory_order_acquire);
+        if (before & 1) continue;
+        out.canId = load(s.canId);
+        out.ts = load(s.ts);
+        out.value = load(s.value);
+        out.updates = load(s.updates);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (load(s.seq) == before) return out.ts != 0;
+    }
+    return false;
+}
+
+} // namespace canmqtt::shm
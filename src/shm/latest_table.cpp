@@ -0,0 +1,170 @@
+#include "shm/latest_table.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace canmqtt::shm {
+
+namespace {
+
+constexpr std::size_t alignUp(std::size_t v, std::size_t a) { return (v + a - 1) / a * a; }
+
+// İsimler bölümü: "ad\0" dizisi; ofset bölüm başından
+uint32_t addString(std::string& strings, std::string_view s)
+{
+    const auto at = static_cast<uint32_t>(strings.size());
+    strings.append(s);
+    strings += '\0';
+    return at;
+}
+
+void write(Slot& slot, uint32_t canId, int64_t ts, double value)
+{
+    // Yazma hakkı: seq çiftken tek yap (aynı slota başka işçi yazıyorsa kısa bekleme)
+    std::atomic_ref<uint32_t> seq(slot.seq);
+    uint32_t cur = seq.load(std::memory_order_relaxed);
+    for (;;) {
+        if (cur & 1) {
+            cur = seq.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (seq.compare_exchange_weak(cur, cur + 1, std::memory_order_acquire, std::memory_order_relaxed)) break;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::atomic_ref<uint32_t>(slot.canId).store(canId, std::memory_order_relaxed);
+    std::atomic_ref<int64_t>(slot.ts).store(ts, std::memory_order_relaxed);
+    std::atomic_ref<double>(slot.value).store(value, std::memory_order_relaxed);
+    std::atomic_ref<uint64_t> updates(slot.updates);
+    updates.store(updates.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    seq.store(cur + 2, std::memory_order_release);
+}
+
+} // namespace
+
+std::unique_ptr<LatestTable> LatestTable::create(const std::string& name, const std::vector<Source>& sources)
+{
+#ifndef _WIN32
+    // İsimler ve slot sayısı önce hesaplanır: segment tek seferde boyutlanır
+    std::string strings;
+    std::vector<SourceEntry> entries;
+    std::vector<Slot> slots;
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        const dbc::DbcDatabase& db = *sources[i].db;
+        SourceEntry e {};
+        e.busOffset = addString(strings, sources[i].bus);
+        e.firstSlot = static_cast<uint32_t>(slots.size());
+        e.slotCount = static_cast<uint32_t>(db.signalCount());
+        e.fingerprint = db.fingerprint();
+        entries.push_back(e);
+
+        slots.resize(slots.size() + db.signalCount());
+        for (const dbc::MessageInfo& m : db.messages()) {
+            const uint32_t message = addString(strings, m.name);
+            for (uint32_t s = m.first_signal; s < m.first_signal + m.signal_count; ++s) {
+                Slot& slot = slots[e.firstSlot + s];
+                slot.messageOffset = message;
+                slot.signalOffset = addString(strings, db.signalName(s));
+                slot.source = static_cast<uint32_t>(i);
+            }
+        }
+    }
+
+    const std::size_t sourcesOffset = alignUp(sizeof(Header), 64);
+    const std::size_t slotsOffset = alignUp(sourcesOffset + entries.size() * sizeof(SourceEntry), 64);
+    const std::size_t stringsOffset = slotsOffset + slots.size() * sizeof(Slot);
+    const std::size_t size = stringsOffset + strings.size();
+
+    // Okuyucular eski segmenti eşlemiş olabilir: onlar retired görene kadar eskisini kullanır
+    ::shm_unlink(name.c_str());
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "[Shm] " << name << " oluşturulamadı: " << std::strerror(errno) << "\n";
+        return nullptr;
+    }
+    void* base = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(size)) == 0)
+        base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const int err = errno;
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "[Shm] " << name << " eşlenemedi: " << std::strerror(err) << "\n";
+        ::shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    auto* bytes = static_cast<char*>(base);
+    std::memcpy(bytes + sourcesOffset, entries.data(), entries.size() * sizeof(SourceEntry));
+    std::memcpy(bytes + slotsOffset, slots.data(), slots.size() * sizeof(Slot));
+    std::memcpy(bytes + stringsOffset, strings.data(), strings.size());
+
+    auto* h = static_cast<Header*>(base);
+    std::memcpy(h->magic, kMagic, sizeof(kMagic));
+    h->headerSize = sizeof(Header);
+    h->slotSize = sizeof(Slot);
+    h->slotCount = static_cast<uint32_t>(slots.size());
+    h->sourceCount = static_cast<uint32_t>(entries.size());
+    h->sourcesOffset = sourcesOffset;
+    h->slotsOffset = slotsOffset;
+    h->stringsOffset = stringsOffset;
+    h->stringsSize = strings.size();
+    h->writerPid = ::getpid();
+    // Sürüm en son yazılır: okuyucu onu görünce gerisi hazırdır
+    std::atomic_ref<uint32_t>(h->version).store(kVersion, std::memory_order_release);
+
+    std::unique_ptr<LatestTable> t(new LatestTable());
+    t->name_ = name;
+    t->base_ = base;
+    t->size_ = size;
+    t->header_ = h;
+    t->sources_ = reinterpret_cast<SourceEntry*>(bytes + sourcesOffset);
+    t->slots_ = reinterpret_cast<Slot*>(bytes + slotsOffset);
+    std::cout << "[Shm] Son değer tablosu: " << name << " (" << slots.size() << " sinyal, " << size / 1024 << " KB)" << std::endl;
+    return t;
+#else
+    (void)sources;
+    std::cerr << "[Shm] " << name << ": paylaşılan bellek tablosu bu platformda desteklenmiyor\n";
+    return nullptr;
+#endif
+}
+
+LatestTable::~LatestTable()
+{
+#ifndef _WIN32
+    if (!base_) return;
+    // Kapanış: okuyucular yazarın gittiğini görür; ad başka tabloya geçmediyse kaldırılır
+    const bool owner = !retired_;
+    retire();
+    if (owner) ::shm_unlink(name_.c_str());
+    ::munmap(base_, size_);
+#endif
+}
+
+void LatestTable::retire()
+{
+    retired_ = true;
+    std::atomic_ref<uint32_t>(header_->retired).store(1, std::memory_order_release);
+}
+
+void LatestTable::update(std::size_t source, const dbc::DbcDatabase& db, const bus::Frame& frame,
+                         dbc::MessageHandle msg, const dbc::DecodedSignals& sigs)
+{
+    if (!msg || source >= header_->sourceCount) return;
+    const SourceEntry& e = sources_[source];
+    if (e.fingerprint != db.fingerprint()) return;
+
+    Slot* base = slots_ + e.firstSlot;
+    for (std::size_t k = 0; k < sigs.size(); ++k)
+        write(base[sigs.index(k)], frame.id, frame.ts.count(), sigs.value(k));
+}
+
+} // namespace canmqtt::shm
@@ -0,0 +1,107 @@
+#include "task/aggregator.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace canmqtt::task {
+
+void Aggregator::reset(Window& w, std::size_t from)
+{
+    // Birikimin etkisiz başlangıç değerleri; min/max ilk örnekte yerini alır
+    std::fill(w.min.begin() + from, w.min.end(), std::numeric_limits<double>::infinity());
+    std::fill(w.max.begin() + from, w.max.end(), -std::numeric_limits<double>::infinity());
+    std::fill(w.sum.begin() + from, w.sum.end(), 0.0);
+    std::fill(w.last.begin() + from, w.last.end(), 0.0);
+    std::fill(w.count.begin() + from, w.count.end(), 0u);
+}
+
+void Aggregator::bind(const dbc::DbcDatabase& db, std::chrono::microseconds now)
+{
+    // Kapanmış pencere kendi blok kopyası ve fingerprint'iyle okunmaya devam eder
+    db_ = &db;
+    index_.clear();
+    layout_.clear();
+    slots_ = 0;
+    Window& w = windows_[active_];
+    for (auto* v : {&w.min, &w.max, &w.sum, &w.last}) v->clear();
+    w.count.clear();
+    w.fingerprint = db.fingerprint();
+    w.start = now;
+}
+
+void Aggregator::add(const bus::Frame& frame, dbc::MessageHandle msg, const dbc::DecodedSignals& sigs)
+{
+    if (!msg || sigs.empty() || !db_) return;
+    Window& w = windows_[active_];
+
+    const uint64_t key = (uint64_t{frame.channel} << 32) | frame.rawId();
+    auto [it, inserted] = index_.try_emplace(key, static_cast<uint32_t>(layout_.size()));
+    if (inserted) {
+        layout_.push_back({key, static_cast<uint32_t>(msg - db_->messages().data()), static_cast<uint32_t>(slots_)});
+        slots_ += msg->signal_count;
+    }
+    if (w.count.size() < slots_) {
+        const std::size_t from = w.count.size();
+        for (auto* v : {&w.min, &w.max, &w.sum, &w.last}) v->resize(slots_);
+        w.count.resize(slots_);
+        reset(w, from);
+    }
+
+    const uint32_t base = layout_[it->second].base;
+    const std::size_t n = sigs.size();
+    const double* v = sigs.values();
+
+    if (n == msg->signal_count && sigs.index(0) == msg->first_signal) {
+        // Tüm sinyaller sırayla: bitişik, dallanmasız (vektörleşebilen) döngü
+        double* mn = w.min.data() + base;
+        double* mx = w.max.data() + base;
+        double* sm = w.sum.data() + base;
+        double* ls = w.last.data() + base;
+        uint32_t* ct = w.count.data() + base;
+        for (std::size_t k = 0; k < n; ++k) {
+            mn[k] = v[k] < mn[k] ? v[k] : mn[k];
+            mx[k] = v[k] > mx[k] ? v[k] : mx[k];
+            sm[k] += v[k];
+            ls[k] = v[k];
+            ++ct[k];
+        }
+        return;
+    }
+
+    // Çoğullanmış mesaj: yalnızca o turda gelen sinyaller
+    for (std::size_t k = 0; k < n; ++k) {
+        const std::size_t j = base + (sigs.index(k) - msg->first_signal);
+        w.min[j] = std::min(w.min[j], v[k]);
+        w.max[j] = std::max(w.max[j], v[k]);
+        w.sum[j] += v[k];
+        w.last[j] = v[k];
+        ++w.count[j];
+    }
+}
+
+void Aggregator::roll(uint64_t tick, std::chrono::microseconds now)
+{
+    Window& done = windows_[active_];
+    done.blocks.assign(layout_.begin(), layout_.end());
+    done.end = now;
+    done.stamp.store(tick, std::memory_order_release);
+
+    // Okuyucu bu pencereyi önceki tick'te bıraktı: yeniden kullanmak güvenli
+    active_ ^= 1;
+    Window& next = windows_[active_];
+    next.stamp.store(0, std::memory_order_relaxed);
+    for (auto* v : {&next.min, &next.max, &next.sum, &next.last}) v->resize(slots_);
+    next.count.resize(slots_);
+    reset(next, 0);
+    next.fingerprint = done.fingerprint;
+    next.start = now;
+}
+
+const Aggregator::Window* Aggregator::closed(uint64_t tick) const
+{
+    for (const Window& w : windows_)
+        if (w.stamp.load(std::memory_order_acquire) == tick) return &w;
+    return nullptr;
+}
+
+} // namespace canmqtt::task
@@ -0,0 +1,200 @@
+#include "task/capture.hpp"
+#include "config/config_loader.hpp"
+#include "dbc/dbc_database.hpp"
+
+#include <filesystem>
+#include <iostream>
+#include <string_view>
+
+namespace canmqtt::task {
+
+namespace {
+
+std::vector<std::string> splitList(std::string_view s)
+{
+    std::vector<std::string> out;
+    while (!s.empty()) {
+        const auto comma = s.find(',');
+        std::string_view item = s.substr(0, comma);
+        while (!item.empty() && (item.front() == ' ' || item.front() == '\t')) item.remove_prefix(1);
+        while (!item.empty() && (item.back()  == ' ' || item.back()  == '\t' || item.back() == '\r')) item.remove_suffix(1);
+        if (!item.empty()) out.emplace_back(item);
+        if (comma == std::string_view::npos) break;
+        s.remove_prefix(comma + 1);
+    }
+    return out;
+}
+
+} // namespace
+
+Capture& Capture::getInstance()
+{
+    static absl::NoDestructor<Capture> instance;
+    return *instance;
+}
+
+std::string Capture::cachePath(const std::string& file) const
+{
+    if (!dbcCache_) return {};
+    if (dbcCacheDir_.empty()) return file + ".vdbc";
+
+    // Aynı adlı iki DBC aynı önbelleği paylaşır; fingerprint uyuşmazsa yeniden derlenir
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(dbcCacheDir_, ec);
+    return (fs::path(dbcCacheDir_) / (fs::path(file).filename().string() + ".vdbc")).string();
+}
+
+dbc::DbcDatabase* Capture::loadDbc(const std::string& file, const std::string& defaultFile)
+{
+    if (auto it = byFile_.find(file); it != byFile_.end()) return it->second;
+
+    // [dbc] file varsayılan örneğe yüklenir; diğer dosyalar için ayrı örnek
+    dbc::DbcDatabase* db;
+    if (file == defaultFile) {
+        db = &dbc::DbcDatabase::getInstance();
+    } else {
+        owned_.push_back(std::make_unique<dbc::DbcDatabase>());
+        db = owned_.back().get();
+    }
+    if (!db->load(file, cachePath(file))) {
+        std::cerr << "[Capture] DBC yüklenemedi: " << file << "\n";
+        if (file != defaultFile) owned_.pop_back();
+        return nullptr;
+    }
+    byFile_.emplace(file, db);
+    return db;
+}
+
+std::string Capture::dbcFileFor(const config::ConfigLoader& cfg, const std::string& section)
+{
+    return cfg.Get(section, "dbc", cfg.Get("dbc", "file", ""));
+}
+
+std::unique_ptr<dbc::DbcDatabase> Capture::loadFresh(const std::string& file) const
+{
+    auto db = std::make_unique<dbc::DbcDatabase>();
+    if (!db->load(file, cachePath(file))) return nullptr;
+    return db;
+}
+
+void Capture::updateDbc(const config::ConfigLoader& cfg, std::size_t index, dbc::DbcDatabase* db, const std::string& file)
+{
+    CaptureChannel& c = channels_[index];
+    c.db = db;
+    c.dbcFile = file;
+    // Replay filtreleri yazılımda ve okuyucu thread'iyle paylaşılıyor; dosyadan okurken önemsiz
+    if (c.backend != "replay") applyFilters(cfg, c.section, c);
+}
+
+void Capture::acceptAll(CaptureChannel& c)
+{
+    if (!c.filtered) return;
+    if (c.channel->setFilters(bus::kAcceptAll)) {
+        c.filtered = false;
+        std::cout << "[Capture] " << c.name << ": kabul filtreleri kaldırıldı" << std::endl;
+    } else {
+        std::cerr << "[Capture] " << c.name << ": eski kabul filtreleri kaldırılamadı\n";
+    }
+}
+
+void Capture::applyFilters(const config::ConfigLoader& cfg, const std::string& section, CaptureChannel& c)
+{
+    // Kapalıyken de çağrılır: hot reload'da önceki DBC'nin filtreleri yüklü kalmamalı
+    if (cfg.Get(section, "filter", cfg.Get("filter", "enable", "0")) != "1") {
+        acceptAll(c);
+        return;
+    }
+
+    std::vector<bus::CanFilter> include, exclude;
+    if (!bus::ParseFilterList(cfg.Get(section, "filter_include", cfg.Get("filter", "include", "")), include) ||
+        !bus::ParseFilterList(cfg.Get(section, "filter_exclude", cfg.Get("filter", "exclude", "")), exclude))
+        std::cerr << "[Capture] " << c.name << ": filtre listesinde hatalı girdi atlandı\n";
+
+    // DBC'deki mesajlar (exclude'a uyanlar hariç) + açıkça istenenler
+    // [j1939] tp=1 ise TP.CM/TP.DT de alınmalı (bkz. Pipeline, J1939Reassembler)
+    std::vector<bus::CanFilter> filters = c.db->acceptanceFilters(exclude, cfg.Get("j1939", "tp", "1") == "1");
+    filters.insert(filters.end(), include.begin(), include.end());
+    if (filters.empty()) {
+        // Kabul edilecek bir şey yoksa yalnızca exclude: "bunlar hariç hepsi"
+        for (auto f : exclude) {
+            f.invert = true;
+            filters.push_back(f);
+        }
+    }
+    if (filters.empty()) {
+        std::cerr << "[Capture] " << c.name << ": filtre üretilemedi (boş DBC?), tüm trafik alınacak\n";
+        acceptAll(c);
+        return;
+    }
+
+    const std::size_t requested = filters.size();
+    filters = bus::CompactFilters(std::move(filters));
+    if (c.channel->setFilters(filters)) {
+        c.filtered = true;
+        std::cout << "[Capture] " << c.name << ": " << filters.size() << " kabul filtresi yüklendi ("
+                  << requested << " girdiden)" << std::endl;
+    } else {
+        std::cerr << "[Capture] " << c.name << ": " << c.backend << " filtreleri uygulayamadı, tüm trafik alınacak\n";
+        acceptAll(c);
+    }
+}
+
+bool Capture::setup(const config::ConfigLoader& cfg)
+{
+    const std::string defaultDbc     = cfg.Get("dbc", "file", "");
+    const std::string defaultBackend = cfg.Get("can", "backend", "socketcan");
+    const std::string defaultFd      = cfg.Get("can", "fd", "0");
+
+    // Derlenmiş DBC önbelleği: yeniden başlatmada ayrıştırma atlanır
+    dbcCache_    = cfg.Get("dbc", "cache", "1") == "1";
+    dbcCacheDir_ = cfg.Get("dbc", "cache_dir", "");
+
+    struct Spec { std::string name, section, backend, iface, dbc; bool fd; };
+    std::vector<Spec> specs;
+
+    const auto names = splitList(cfg.Get("can", "channels", ""));
+    if (names.empty()) {
+        const std::string iface = cfg.Get("can", "channel", "");
+        specs.push_back({iface, "can", defaultBackend, iface, defaultDbc, defaultFd == "1"});
+    } else {
+        for (const auto& name : names) {
+            const std::string section = "can." + name;
+            specs.push_back({name, section,
+                             cfg.Get(section, "backend", defaultBackend),
+                             cfg.Get(section, "interface", name),
+                             dbcFileFor(cfg, section),
+                             cfg.Get(section, "fd", defaultFd) == "1"});
+        }
+    }
+
+    for (auto& spec : specs) {
+        if (channels_.size() >= 0x100) {
+            std::cerr << "[Capture] En fazla 256 kanal desteklenir, " << spec.name << " atlandı\n";
+            continue;
+        }
+        auto ch = bus::ICanChannel::create(spec.backend, spec.section);
+        if (!ch) {
+            std::cerr << "[Capture] CAN backend oluşturulamadı: " << spec.backend << " (" << spec.name << ")\n";
+            continue;
+        }
+        if (!ch->open(spec.iface, spec.fd)) {
+            std::cerr << "[Capture] CAN backend açılamadı: " << spec.backend << " " << spec.iface << "\n";
+            continue;
+        }
+        // DBC'siz kanal çözülemez: kanal açılmamış sayılır (hiç kanal kalmazsa dinleyici başlamaz)
+        dbc::DbcDatabase* db = loadDbc(spec.dbc, defaultDbc);
+        if (!db) {
+            std::cerr << "[Capture] " << spec.name << " atlandı: DBC yok\n";
+            continue;
+        }
+        std::cout << "[Capture] Kanal " << channels_.size() << ": " << spec.name << " (" << spec.backend
+                  << " " << spec.iface << ", dbc=" << spec.dbc << ")" << std::endl;
+        channels_.push_back({std::move(spec.name), std::move(spec.backend), std::move(spec.iface), std::move(ch), db,
+                             spec.section, spec.dbc});
+        applyFilters(cfg, spec.section, channels_.back());
+    }
+    return !channels_.empty();
+}
+
+} // namespace canmqtt::task
@@ -0,0 +1,91 @@
+#include "task/conflator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace canmqtt::task {
+
+Conflator::Conflator(std::size_t capacity, std::chrono::milliseconds heartbeat)
+    : heartbeat_(heartbeat)
+{
+    // %75 dolulukta durulur: doğrusal yoklama kısa kalır
+    const std::size_t size = std::bit_ceil(std::max<std::size_t>(capacity, 16) * 4 / 3 + 1);
+    keys_.assign(size, 0);
+    slots_.resize(size);
+    mask_ = size - 1;
+    limit_ = size * 3 / 4;
+    used_.reserve(limit_);
+}
+
+bool Conflator::samePayload(const bus::Frame& a, const bus::Frame& b)
+{
+    return a.len == b.len && a.flags == b.flags && std::memcmp(a.data, b.data, a.len) == 0;
+}
+
+void Conflator::copy(bus::Frame& to, const bus::Frame& from)
+{
+    // [len, 8) sıfır tutulduğu için klasik frame'de 8 bayt yeter; FD'de len kadar
+    to.id      = from.id;
+    to.len     = from.len;
+    to.flags   = from.flags;
+    to.channel = from.channel;
+    to.ts      = from.ts;
+    std::memcpy(to.data, from.data, std::max<std::size_t>(from.len, 8));
+}
+
+Conflator::Slot* Conflator::slot(const bus::Frame& f, bool& fresh)
+{
+    const uint64_t key = keyOf(f);
+    std::size_t i = static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> 40) & mask_;
+    for (;; i = (i + 1) & mask_) {
+        if (keys_[i] == key) {
+            fresh = false;
+            return &slots_[i];
+        }
+        if (keys_[i] == 0) break;
+    }
+    if (used_.size() >= limit_) return nullptr;
+
+    keys_[i] = key;
+    used_.push_back(static_cast<uint32_t>(i));
+    fresh = true;
+    return &slots_[i];
+}
+
+bool Conflator::changed(const bus::Frame& f)
+{
+    bool fresh = false;
+    Slot* s = slot(f, fresh);
+    if (!s) {
+        ++overflow_;
+        return true;
+    }
+    if (!fresh && samePayload(s->last, f) && (heartbeat_.count() == 0 || f.ts - s->sent < heartbeat_)) {
+        ++suppressed_;
+        return false;
+    }
+    copy(s->last, f);
+    s->sent = f.ts;
+    return true;
+}
+
+bool Conflator::store(const bus::Frame& f)
+{
+    bool fresh = false;
+    Slot* s = slot(f, fresh);
+    if (!s) {
+        ++overflow_;
+        return false;
+    }
+    if (fresh || s->dirty || !samePayload(s->last, f)) {
+        if (s->dirty) ++suppressed_;          // yayınlanmamış ara değer ezildi
+        copy(s->last, f);
+        s->dirty = true;
+    } else {
+        ++suppressed_;                        // yayınlanmış değerin tekrarı
+    }
+    return true;
+}
+
+} // namespace canmqtt::task
@@ -0,0 +1,193 @@
+#include "task/hot_reload.hpp"
+#include "task/capture.hpp"
+#include "task/pipeline.hpp"
+#include "config/config_loader.hpp"
+#include "dbc/dbc_database.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace canmqtt::task {
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+HotReload::HotReload(config::ConfigLoader& cfg, Capture& capture, Pipeline& pipeline,
+                     std::chrono::milliseconds debounce)
+    : cfg_(cfg), capture_(capture), pipeline_(pipeline), debounce_(debounce)
+{
+}
+
+HotReload::~HotReload()
+{
+    stop();
+}
+
+void HotReload::start()
+{
+    // Başlangıç damgaları: yalnızca bundan sonraki değişiklikler uygulanır
+    for (const auto& f : watchedFiles()) touched(f);
+    thread_ = std::jthread([this](std::stop_token st) { run(st); });
+}
+
+void HotReload::stop()
+{
+    if (!thread_.joinable()) return;
+    thread_.request_stop();
+    thread_.join();
+}
+
+std::vector<std::string> HotReload::watchedFiles() const
+{
+    std::vector<std::string> files;
+    if (auto path = cfg_.Path(); !path.empty()) files.push_back(std::move(path));
+    for (const auto& c : capture_.channels())
+        if (!c.dbcFile.empty() && std::find(files.begin(), files.end(), c.dbcFile) == files.end())
+            files.push_back(c.dbcFile);
+    return files;
+}
+
+bool HotReload::touched(const std::string& file)
+{
+    std::error_code ec;
+    const auto t = fs::last_write_time(file, ec);
+    if (ec) return false;                      // silinmiş ya da yeniden adlandırılıyor: eskiyle devam
+    auto [it, inserted] = stamps_.try_emplace(file, t);
+    if (inserted) return true;
+    if (it->second == t) return false;
+    it->second = t;
+    return true;
+}
+
+void HotReload::applyOptions()
+{
+    pipeline_.setEcho(cfg_.Get("console", "echo", "1") == "1");
+    pipeline_.setStatsInterval(std::chrono::seconds(cfg_.GetNumber("pipeline", "stats_interval_s", 0)));
+}
+
+void HotReload::check()
+{
+    const std::string cfgPath = cfg_.Path();
+    if (!cfgPath.empty() && touched(cfgPath)) {
+        if (cfg_.Reload()) {
+            applyOptions();
+            std::cout << "[HotReload] Config yeniden yüklendi: " << cfgPath
+                      << " (dbc, echo, stats_interval_s uygulandı; diğerleri yeniden başlatmada)" << std::endl;
+        } else {
+            std::cerr << "[HotReload] Config okunamadı, eski ayarlarla devam\n";
+        }
+    }
+
+    auto& channels = capture_.channels();
+    std::unordered_map<std::string, bool> modified;                 // dosya başına bir kez bakılır
+    std::unordered_map<std::string, dbc::DbcDatabase*> fresh;       // bu turda derlenen (nullptr: yüklenemedi)
+    std::vector<std::unique_ptr<dbc::DbcDatabase>> built;
+    std::size_t swapped = 0;
+
+    for (std::size_t i = 0; i < channels.size(); ++i) {
+        CaptureChannel& c = channels[i];
+        const std::string file = Capture::dbcFileFor(cfg_, c.section);
+        auto [mod, first] = modified.try_emplace(file, false);
+        if (first) mod->second = touched(file);
+        if (file == c.dbcFile && !mod->second) continue;
+
+        auto it = fresh.find(file);
+        if (it == fresh.end()) {
+            // Derleme bu thread'de: hat eski tablolarla çözmeye devam eder
+            auto db = capture_.loadFresh(file);
+            if (!db) std::cerr << "[HotReload] " << file << " yüklenemedi, eski DBC ile devam\n";
+            it = fresh.emplace(file, db.get()).first;
+            if (db) built.push_back(std::move(db));
+        }
+        dbc::DbcDatabase* db = it->second;
+        if (!db) continue;
+        if (db->fingerprint() == c.db->fingerprint()) {      // içerik aynı: değişime gerek yok
+            c.dbcFile = file;
+            continue;
+        }
+
+        pipeline_.replaceDbc(i, *db);
+        capture_.updateDbc(cfg_, i, db, file);
+        ++swapped;
+        std::cout << "[HotReload] " << c.name << ": yeni DBC devrede (" << file << ", "
+                  << db->messages().size() << " mesaj)" << std::endl;
+    }
+    if (swapped == 0) return;
+
+    // Eski sürümü tutan işçi kalmayınca artık hiçbir kanalın kullanmadıklarını bırak
+    pipeline_.synchronize();
+    std::vector<std::unique_ptr<dbc::DbcDatabase>> keep;
+    for (auto* list : {&owned_, &built})
+        for (auto& db : *list)
+            if (std::any_of(channels.begin(), channels.end(), [&](const CaptureChannel& c) { return c.db == db.get(); }))
+                keep.push_back(std::move(db));
+    owned_ = std::move(keep);
+}
+
+void HotReload::run(std::stop_token st)
+{
+#ifdef __linux__
+    const int fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd >= 0) {
+        std::unordered_map<int, fs::path> dirs;     // wd → dizin
+        std::vector<std::string> files;             // mutlak, normalize yollar
+        auto watch = [&] {
+            files.clear();
+            for (const auto& f : watchedFiles()) {
+                std::error_code ec;
+                const fs::path p = fs::absolute(f, ec).lexically_normal();
+                files.push_back(p.string());
+                // Editörler çoğu zaman yeni dosya yazıp yeniden adlandırır: dosya değil dizin izlenir
+                const int wd = ::inotify_add_watch(fd, p.parent_path().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+                if (wd >= 0) dirs[wd] = p.parent_path();
+            }
+        };
+        watch();
+
+        bool pending = false;
+        auto last = Clock::now();
+        alignas(inotify_event) char buf[4096];
+        while (!st.stop_requested()) {
+            pollfd pfd {fd, POLLIN, 0};
+            if (::poll(&pfd, 1, 100) > 0) {
+                for (ssize_t len; (len = ::read(fd, buf, sizeof(buf))) > 0;) {
+                    for (const char* p = buf; p < buf + len;) {
+                        const auto* ev = reinterpret_cast<const inotify_event*>(p);
+                        p += sizeof(inotify_event) + ev->len;
+                        const auto it = dirs.find(ev->wd);
+                        if (ev->len == 0 || it == dirs.end()) continue;
+                        const std::string path = (it->second / ev->name).string();
+                        if (std::find(files.begin(), files.end(), path) != files.end()) {
+                            pending = true;
+                            last = Clock::now();
+                        }
+                    }
+                }
+            }
+            // Art arda yazmalar (editör, git checkout) durulunca bir kez uygula
+            if (pending && Clock::now() - last >= debounce_) {
+                pending = false;
+                check();
+                watch();                            // dbc yolu değişmiş olabilir
+            }
+        }
+        ::close(fd);
+        return;
+    }
+    std::cerr << "[HotReload] inotify kullanılamıyor (" << std::strerror(errno) << "), yoklamaya geçildi\n";
+#endif
+    while (!st.stop_requested()) {
+        for (int i = 0; i < 10 && !st.stop_requested(); ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        check();
+    }
+}
+
+} // namespace canmqtt::task
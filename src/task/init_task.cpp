@@ -2,10 +2,11 @@
 #include "task/init_task.hpp"
 
 #include "config/config_loader.hpp"
-#include "bus/can_channel.hpp"
-#include "dbc/dbc_database.hpp"
+#include "task/capture.hpp"
 #include "mqtt/mqtt_publisher.hpp"
 
+#include <iostream>
+
 std::string stringdbc;
 
 namespace canmqtt::task {
@@ -20,15 +21,9 @@ void Init() {
     }
   }
 
-  auto& db = canmqtt::dbc::DbcDatabase::getInstance();
-  db.load(cfg.Get("dbc", "file", ""));
-
-  auto backend = cfg.Get("can","backend","socketcan");
-  auto* ch = canmqtt::bus::ICanChannel::create(backend);
-  if(!ch){
-    std::cerr << "[Init] CAN backend oluşturulamadı: " << backend << "\n";
-  } else if(!ch->open(cfg.Get("can", "channel", ""))){
-    std::cerr << "[Init] CAN backend açılamadı: " << backend << "\n";
+  // Kanallar ve kanal başına DBC'ler ([can] channels)
+  if(!canmqtt::task::Capture::getInstance().setup(cfg)){
+    std::cerr << "[Init] Hiçbir CAN kanalı açılamadı\n";
   }
 
   auto& mqtt_pub = canmqtt::mqtt::Publisher::getInstance();
@@ -42,7 +37,11 @@ void Init() {
   } catch(...) {
     try { keepAlive = std::stoi(keepStr, nullptr, 16); } catch(...) { keepAlive = 60; }
   }
+  canmqtt::mqtt::PublisherOptions pubOpts;
+  pubOpts.queue_size = cfg.GetNumber<std::size_t>("mqtt","queue_size",4096);
+  pubOpts.inflight   = cfg.GetNumber("mqtt","inflight",10);
+  pubOpts.overflow = canmqtt::mqtt::Publisher::ParsePolicy(cfg.Get("mqtt","overflow","drop_oldest"));
   std::cout << "[Init] MQTT uri=" << uri << " client_id=" << cid << " keep=" << keepAlive << std::endl;
-  mqtt_pub.Init(uri, cid, keepAlive);
+  mqtt_pub.Init(uri, cid, keepAlive, pubOpts);
 }
 } 
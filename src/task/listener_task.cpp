@@ -1,26 +1,25 @@
 #include "task/listener_task.hpp"
 #include "dbc/dbc_database.hpp"
-#include "bus/can_channel.hpp"
 #include "mqtt/mqtt_publisher.hpp"
+#include "task/capture.hpp"
+#include "task/hot_reload.hpp"
+#include "task/periodic_task.hpp"
+#include "task/pipeline.hpp"
+#include "task/recorder.hpp"
 #include "config/config_loader.hpp"
 #include "util/util.hpp"
+#include "util/binary_serializer.hpp"
+#include "shm/latest_layout.hpp"
 
-#include <nlohmann/json.hpp>
 #include <iostream>
-#include <iomanip>
-#include <sstream>
+#include <memory>
 #include <chrono>
-#include <thread>
-#include <fmt/core.h>         
-
-using canmqtt::bus::Frame;
-using json = nlohmann::json;
+#include <vector>
 
 namespace cfg = canmqtt::config;
 namespace dbc = canmqtt::dbc;
-namespace bus = canmqtt::bus;
 namespace mqtt = canmqtt::mqtt;
-namespace build_json = canmqtt::util::json;
+namespace util = canmqtt::util;
 
 namespace canmqtt::task
 {
@@ -28,51 +27,121 @@ namespace canmqtt::task
   void StartListener()
   {
     auto &cl = cfg::ConfigLoader::getInstance();
-    auto &db = dbc::DbcDatabase::getInstance();
-    auto backend = cl.Get("can","backend","socketcan");
-    auto *ch = bus::ICanChannel::create(backend);
-    if(!ch){
-      std::cerr << "[Listener] CAN backend bulunamadı: " << backend << "\n";
+    auto &capture = Capture::getInstance();
+    if(capture.channels().empty()){
+      std::cerr << "[Listener] Açık CAN kanalı yok\n";
       return; 
     }
-  std::cout << "[Listener] Backend: " << backend << " kanal: " << cl.Get("can","channel","") << " bekleniyor..." << std::endl;
     auto &mqtt_pub = mqtt::Publisher::getInstance();
 
-    std::jthread{
-        [&](void){
-          Frame frame;
-          json j_canFrame;
-
-          bool firstFrameLogged=false;
-          while (ch->read(frame))
-          {
-            if(!firstFrameLogged){
-              std::cout << "[Listener] İlk frame alındı (id=0x" << std::hex << frame.id << std::dec << ")" << std::endl;
-              firstFrameLogged=true;
-            }
-            /* 
-            
-              FRAME
-
-              cyber security  
-
-
-
-
-            */
-            if(build_json::BuildJson(j_canFrame,frame,cl,db) == false)
-            {
-              std::cerr << "Failed to build JSON for CAN frame with ID: " << frame.id << '\n';
-              continue;
-            }
-            
-            std::string busName = cl.Get("can", "channel", "");
-            std::string topic = fmt::format("can/{}/{:06X}", busName, frame.id);
-
-            mqtt_pub.Publish(topic, j_canFrame.dump(2), 1/*td::stoi(cl.Get("mqtt", "qos", ""),nullptr, 16)*/);
-          }
-        }}
-        .detach();
+    PipelineOptions opts;
+    // Konsol çıktısı isteğe bağlı: her frame'i basmak yüksek yükte darboğaz olur
+    opts.echo   = cl.Get("console", "echo", "1") == "1";
+    opts.pretty = cl.Get("console", "pretty", "1") == "1";
+
+    // Toplu gönderim: batch_window_ms > 0 ise frame'ler tek MQTT mesajında toplanır
+    opts.batch_window_ms  = cl.GetNumber("mqtt", "batch_window_ms", 0);
+    opts.batch_max_frames = cl.GetNumber<std::size_t>("mqtt", "batch_max_frames", 256);
+    opts.qos              = 1/*td::stoi(cl.Get("mqtt", "qos", ""),nullptr, 16)*/;
+
+    // İkili biçimde sinyal indeksleri şemaya bağlıdır; şema kanal başına retained yayınlanır
+    opts.binary = cl.Get("mqtt", "format", "json") == "binary";
+
+    std::vector<PipelineSource> sources;
+    for (auto &c : capture.channels()) {
+      std::cout << "[Listener] Backend: " << c.backend << " kanal: " << c.iface << " (" << c.name << ") bekleniyor..." << std::endl;
+      if (opts.binary)
+        mqtt_pub.Publish("can/" + c.name + "/schema", util::BuildSchemaJson(*c.db), 1, true);
+      sources.push_back({c.channel.get(), c.name, c.db});
+    }
+
+    opts.workers        = cl.GetNumber<std::size_t>("pipeline", "workers", 2);
+    opts.queue_size     = cl.GetNumber<std::size_t>("pipeline", "queue_size", 4096);
+    opts.stats_interval = std::chrono::seconds(cl.GetNumber("pipeline", "stats_interval_s", 0));
+
+    // J1939 çok paketli PGN'ler (BAM, RTS/CTS) tek mantıksal mesaj olarak çözülür
+    opts.j1939_tp          = cl.Get("j1939", "tp", "1") == "1";
+    opts.tp_max_sessions   = cl.GetNumber<std::size_t>("j1939", "tp_max_sessions", 256);
+    opts.tp_timeout        = std::chrono::milliseconds(cl.GetNumber("j1939", "tp_timeout_ms", 750));
+    opts.tp_publish_frames = cl.Get("j1939", "tp_publish_frames", "0") == "1";
+
+    // Değişmeyen tekrarlar: changes = yalnızca değişenler, conflate = periyodik turda son değer
+    const std::string dedup = cl.Get("dedup", "mode", "off");
+    opts.dedup       = dedup == "changes" ? DedupMode::Changes : dedup == "conflate" ? DedupMode::Conflate : DedupMode::Off;
+    opts.dedup_table = cl.GetNumber<std::size_t>("dedup", "table_size", 4096);
+    opts.heartbeat   = std::chrono::milliseconds(cl.GetNumber("dedup", "heartbeat_ms", 1000));
+
+    // Sinyal bazında yayın kuralları: [publish] default / Mesaj / Mesaj.Sinyal = deadband=..,pct=..,min_ms=..,max_ms=..
+    if (const auto section = cl.Section("publish"); !section.empty()) {
+      for (const auto &[key, value] : section) {
+        PublishRuleSpec spec;
+        if (!ParsePublishRule(value, spec.rule)) {
+          std::cerr << "[Listener] [publish] " << key << " kuralı geçersiz, atlandı: " << value << std::endl;
+          continue;
+        }
+        const auto dot = key.find('.');
+        spec.message = key == "default" ? "*" : key.substr(0, dot);
+        if (key != "default" && dot != std::string::npos) spec.signal = key.substr(dot + 1);
+        opts.publish_rules.push_back(std::move(spec));
+      }
+      std::cout << "[Listener] " << opts.publish_rules.size() << " yayın kuralı yüklendi" << std::endl;
+    }
+
+    // Pencereli istatistik: pencere boyu [os] periodic_task_interval_ms
+    opts.aggregate     = cl.Get("aggregate", "enable", "0") == "1";
+    opts.aggregate_raw = cl.Get("aggregate", "raw", "1") == "1";
+
+    // Son sinyal geçmişi (süreç içi): ekran görevi ve yerel okuyucular için
+    if (cl.Get("history", "enable", "0") == "1") {
+      HistoryOptions ho;
+      ho.depth     = cl.GetNumber<std::size_t>("history", "depth", 4096);
+      ho.memory_mb = cl.GetNumber<std::size_t>("history", "memory_mb", 64);
+      auto &history = SignalHistory::getInstance();
+      if (history.init(ho))
+        opts.history = &history;
+      else
+        std::cerr << "[Listener] Sinyal geçmişi açılamadı\n";
+    }
+
+    // Ham kayıt: MQTT'den bağımsız, kendi halkası ve yazıcı thread'i ile
+    static std::unique_ptr<Recorder> recorder;
+    if (cl.Get("recorder", "enable", "0") == "1") {
+      RecorderOptions ro;
+      ro.dir            = cl.Get("recorder", "dir", ro.dir);
+      ro.prefix         = cl.Get("recorder", "prefix", ro.prefix);
+      ro.segment_mb     = cl.GetNumber<std::size_t>("recorder", "segment_mb", 64);
+      ro.max_segments   = cl.GetNumber<std::size_t>("recorder", "max_segments", 0);
+      ro.index_interval = cl.GetNumber<uint32_t>("recorder", "index_interval", 1024);
+      ro.queue_size     = cl.GetNumber<std::size_t>("recorder", "queue_size", 65536);
+      ro.flush_interval = std::chrono::milliseconds(cl.GetNumber("recorder", "flush_interval_ms", 1000));
+
+      std::vector<std::string> names;
+      for (auto &c : capture.channels()) names.push_back(c.name);
+      recorder = std::make_unique<Recorder>(ro, std::move(names));
+      if (!recorder->start()) {
+        std::cerr << "[Listener] Kaydedici başlatılamadı, kayıt yapılmayacak\n";
+        recorder.reset();
+      }
+    }
+
+    // Süreç sonuna kadar yaşar (main sonsuz döngüde bekler)
+    static std::unique_ptr<Pipeline> pipeline;
+    pipeline = std::make_unique<Pipeline>(std::move(sources), mqtt_pub, opts, recorder.get());
+    // Yerel süreçler (HMI, görüntüleyici) son değerleri broker'sız okur (bkz. shm/latest_reader.hpp)
+    if (cl.Get("shm", "enable", "0") == "1" && !pipeline->exportLatest(cl.Get("shm", "name", canmqtt::shm::kDefaultName)))
+      std::cerr << "[Listener] Paylaşılan bellek tablosu açılamadı, devam ediliyor\n";
+    pipeline->start();
+    std::cout << "[Listener] " << pipeline->workerCount() << " işçi thread ile hat başlatıldı" << std::endl;
+    if (opts.dedup == DedupMode::Conflate || opts.aggregate)
+      OnPeriodicTick([] { pipeline->tick(); });
+
+    // Config ve DBC değişiklikleri hat durmadan uygulanır (bkz. HotReload)
+    static std::unique_ptr<HotReload> reload;
+    if (cl.Get("reload", "enable", "1") == "1") {
+      reload = std::make_unique<HotReload>(cl, capture, *pipeline,
+                                           std::chrono::milliseconds(cl.GetNumber("reload", "debounce_ms", 300)));
+      reload->start();
+    }
   }
 
 } // namespace canmqtt::task
@@ -1,11 +1,14 @@
 #include "task/periodic_task.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <thread>
 #include <chrono>
 #include <iomanip>
+#include <mutex>
 #include <stop_token>
+#include <vector>
 
 #include "config/config_loader.hpp"
 
@@ -13,19 +16,40 @@ namespace canmqtt::task {
 
 using namespace std::chrono;
 
+namespace {
+std::mutex tickMutex;
+std::vector<std::function<void()>> tickHandlers;
+}  // namespace
+
+void OnPeriodicTick(std::function<void()> fn) {
+  std::lock_guard lock(tickMutex);
+  tickHandlers.push_back(std::move(fn));
+}
+
 void StartPeriodic() {
   using namespace std::chrono_literals;
-  int interval_ms = std::stoi(
-      canmqtt::config::ConfigLoader::getInstance().Get("os",
+  int interval_ms = canmqtt::config::ConfigLoader::getInstance().GetNumber("os",
                                          "periodic_task_interval_ms",
-                                         ""));
+                                         500);
   std::jthread
   {
     [interval_ms](void) 
     {
+      // Sabit takvim: işleyicilerin süresi aralığa eklenmez, tikler kaymaz
+      const auto interval = std::chrono::milliseconds(std::max(interval_ms, 1));
+      auto deadline = steady_clock::now() + interval;
       while (true) {
         //std::cout << "Periodic task running every " << interval_ms << " ms" <<   << std::endl;
-        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+        std::this_thread::sleep_until(deadline);
+        {
+          std::lock_guard lock(tickMutex);
+          for (auto& fn : tickHandlers) fn();
+        }
+        deadline += interval;
+        // Bir aralıktan fazla geride kalındıysa (askıya alma, uzun işleyici)
+        // kaçan tikler art arda çalıştırılmaz; takvim şimdiden yeniden kurulur
+        if (const auto now = steady_clock::now(); now - deadline > interval)
+          deadline = now + interval;
       }
     }
   }.detach();
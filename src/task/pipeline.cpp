@@ -0,0 +1,676 @@
+#include "task/pipeline.hpp"
+#include "task/recorder.hpp"
+#include "bus/j1939_tp.hpp"
+#include "task/conflator.hpp"
+#include "dbc/dbc_database.hpp"
+#include "mqtt/mqtt_publisher.hpp"
+#include "mqtt/frame_batcher.hpp"
+#include "shm/latest_table.hpp"
+#include "util/frame_serializer.hpp"
+#include "util/binary_serializer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <fmt/core.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+namespace canmqtt::task
+{
+
+    using bus::Frame;
+    using Clock = std::chrono::steady_clock;
+
+    Pipeline::Pipeline(std::vector<PipelineSource> sources,
+                       mqtt::Publisher& pub,
+                       const PipelineOptions& opts,
+                       Recorder* recorder)
+        : sources_(std::move(sources)),
+          state_(std::make_unique<SourceState[]>(sources_.size())),
+          pub_(pub), opts_(opts), recorder_(recorder),
+          echo_(opts.echo), statsInterval_(opts.stats_interval.count())
+    {
+        for (std::size_t i = 0; i < sources_.size(); ++i)
+            state_[i].db.store(sources_[i].db);
+
+        std::size_t n = opts_.workers;
+        if (n == 0)
+        {
+            // Okuyucu ve MQTT gönderici için bir çekirdek bırak
+            const unsigned hw = std::thread::hardware_concurrency();
+            n = hw > 1 ? hw - 1 : 1;
+        }
+        workers_.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            workers_.push_back(std::make_unique<Worker>(opts_.queue_size));
+            if (opts_.aggregate)
+                for (std::size_t s = 0; s < sources_.size(); ++s)
+                    workers_.back()->aggregators.push_back(std::make_unique<Aggregator>());
+        }
+    }
+
+    Pipeline::~Pipeline()
+    {
+        stop();
+    }
+
+    void Pipeline::start()
+    {
+        for (std::size_t i = 0; i < workers_.size(); ++i)
+        {
+            Worker& w = *workers_[i];
+            w.thread = std::jthread([this, &w, i](std::stop_token st) { workerLoop(st, w, i); });
+        }
+
+        // Beklenebilir tanıtıcısı olan kanallar tek epoll thread'inde toplanır
+        std::vector<std::size_t> pollable;
+        std::vector<std::size_t> blocking;
+        for (std::size_t i = 0; i < sources_.size(); ++i)
+        {
+#ifdef __linux__
+            if (sources_.size() > 1 && sources_[i].channel->nativeHandle() >= 0)
+            {
+                pollable.push_back(i);
+                continue;
+            }
+#endif
+            blocking.push_back(i);
+        }
+
+        lastStats_ = Clock::now();
+        prevStats_ = stats();
+        if (!pollable.empty())
+            readers_.emplace_back([this, pollable](std::stop_token st) { pollLoop(st, pollable, true); });
+        for (std::size_t i : blocking)
+        {
+            const bool statsOwner = readers_.empty();
+            readers_.emplace_back([this, i, statsOwner](std::stop_token st) { readerLoop(st, i, statsOwner); });
+        }
+    }
+
+    void Pipeline::stop()
+    {
+        // Önce okuyucular (en geç okuma zaman aşımı kadar sonra döner), sonra kalanları boşaltan işçiler
+        for (auto& r : readers_)
+            r.request_stop();
+        for (auto& r : readers_)
+            if (r.joinable()) r.join();
+        readers_.clear();
+
+        for (auto& w : workers_)
+            if (w->thread.joinable()) w->thread.request_stop();
+        wakeAll();
+        for (auto& w : workers_)
+            if (w->thread.joinable()) w->thread.join();
+    }
+
+    PipelineStats Pipeline::stats() const
+    {
+        PipelineStats s;
+        s.readPerSource.reserve(sources_.size());
+        for (std::size_t i = 0; i < sources_.size(); ++i)
+        {
+            const uint64_t r = state_[i].read.load(std::memory_order_relaxed);
+            s.readPerSource.push_back(r);
+            s.read += r;
+        }
+        s.processed.reserve(workers_.size());
+        for (const auto& w : workers_)
+        {
+            s.dropped += w->dropped.load(std::memory_order_relaxed);
+            s.processed.push_back(w->processed.load(std::memory_order_relaxed));
+            s.tpCompleted += w->tpCompleted.load(std::memory_order_relaxed);
+            s.tpFailed += w->tpFailed.load(std::memory_order_relaxed);
+            s.suppressed += w->suppressed.load(std::memory_order_relaxed);
+            s.ruleSuppressed += w->ruleSuppressed.load(std::memory_order_relaxed);
+            s.unencodable += w->unencodable.load(std::memory_order_relaxed);
+        }
+        return s;
+    }
+
+    void Pipeline::replaceDbc(std::size_t source, const dbc::DbcDatabase& db)
+    {
+        // Tüketici yeni fingerprint'li kayıtlardan önce yeni şemayı almalı
+        if (opts_.binary)
+            pub_.Publish("can/" + sources_[source].busName + "/schema", util::BuildSchemaJson(db), 1, true);
+        state_[source].db.store(&db);
+    }
+
+    std::unique_ptr<shm::LatestTable> Pipeline::buildLatest(const std::string& name) const
+    {
+        std::vector<shm::LatestTable::Source> tableSources;
+        for (std::size_t i = 0; i < sources_.size(); ++i)
+            tableSources.push_back({sources_[i].busName, state_[i].db.load()});
+        return shm::LatestTable::create(name, tableSources);
+    }
+
+    bool Pipeline::exportLatest(const std::string& name)
+    {
+        latestOwned_ = buildLatest(name);
+        latest_.store(latestOwned_.get(), std::memory_order_release);
+        return latestOwned_ != nullptr;
+    }
+
+    void Pipeline::synchronize()
+    {
+        // Yerleşim DBC'ye bağlı: yeni tablo aynı adla kurulur, eskisi grace period sonunda bırakılır
+        std::unique_ptr<shm::LatestTable> oldLatest;
+        if (latestOwned_)
+        {
+            bool changed = false;
+            for (std::size_t i = 0; i < sources_.size(); ++i)
+                changed |= latestOwned_->fingerprint(i) != state_[i].db.load()->fingerprint();
+            if (changed)
+            {
+                if (auto fresh = buildLatest(latestOwned_->name()))
+                {
+                    oldLatest = std::move(latestOwned_);
+                    latestOwned_ = std::move(fresh);
+                    latest_.store(latestOwned_.get(), std::memory_order_release);
+                }
+            }
+        }
+
+        // Dönem değişimden sonra artar: bu değeri (ya da çevrim dışı) gösteren işçi
+        // değişimden önceki göstericiyi artık tutmuyordur
+        const uint64_t target = epoch_.fetch_add(1) + 1;
+        for (const auto& w : workers_)
+        {
+            for (;;)
+            {
+                const uint64_t q = w->quiescent.load();
+                if (q == kOffline || q >= target) break;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        // Toplama yayını işçi değildir: elindeki DBC göstericisini bırakmasını bekle
+        std::lock_guard lock(aggMutex_);
+        if (oldLatest)
+            oldLatest->retire();
+    }
+
+    std::size_t Pipeline::route(const Frame& frame) const
+    {
+        // Aynı (kanal, ham ID) → aynı işçi; ardışık ID'ler de dağılsın diye çarpımsal karıştırma.
+        // TP.CM ve TP.DT'nin ID'leri farklıdır: oturum tek işçide birleşsin diye yalnızca (kanal, SA)
+        const uint32_t key = opts_.j1939_tp && bus::J1939Reassembler::isTp(frame)
+                                 ? (0xEBu << 16) | (frame.id & 0xFF)
+                                 : frame.rawId();
+        const uint32_t h = ((key ^ (uint32_t{frame.channel} << 29)) * 0x9E3779B1u) >> 16;
+        return h % workers_.size();
+    }
+
+    void Pipeline::tick()
+    {
+        // İşçiler t'de kapattıkları pencereye t+1 gelene kadar dokunmaz
+        if (opts_.aggregate)
+            publishAggregates(tick_.load(std::memory_order_relaxed));
+        tick_.fetch_add(1, std::memory_order_release);
+        wakeAll();
+    }
+
+    void Pipeline::publishAggregates(uint64_t tick)
+    {
+        if (tick == 0) return;
+        std::lock_guard lock(aggMutex_);
+        for (std::size_t s = 0; s < sources_.size(); ++s)
+        {
+            const dbc::DbcDatabase& db = *state_[s].db.load(std::memory_order_acquire);
+            const auto& messages = db.messages();
+            std::string& out = aggBuf_;
+            out.clear();
+            std::size_t records = 0;
+            std::chrono::microseconds start = std::chrono::microseconds::max(), end {};
+
+            // (kanal, ID) tek işçiye gider: işçilerin pencereleri çakışmaz, art arda eklenir
+            for (const auto& w : workers_)
+            {
+                const Aggregator::Window* win = w->aggregators[s]->closed(tick);
+                if (!win || win->fingerprint != db.fingerprint()) continue;   // DBC değişimi: pencere atılır
+                start = std::min(start, win->start);
+                end = std::max(end, win->end);
+                for (const Aggregator::Block& b : win->blocks)
+                {
+                    const dbc::MessageInfo& m = messages[b.message];
+                    bool any = false;
+                    for (uint32_t k = 0; k < m.signal_count; ++k)
+                    {
+                        const std::size_t j = b.base + k;
+                        if (j >= win->count.size() || win->count[j] == 0) continue;
+                        if (!any)
+                        {
+                            out += records++ ? ",{\"id\":" : "{\"id\":";
+                            util::appendNumber(out, static_cast<uint64_t>(b.key & 0xFFFFFFFFu));
+                            out += ",\"name\":\"";
+                            util::appendEscaped(out, m.name);
+                            out += "\",\"signals\":{";
+                            any = true;
+                        }
+                        else
+                        {
+                            out += ',';
+                        }
+                        out += '"';
+                        util::appendEscaped(out, db.signalName(m.first_signal + k));
+                        out += "\":{\"min\":";
+                        util::appendNumber(out, win->min[j]);
+                        out += ",\"max\":";
+                        util::appendNumber(out, win->max[j]);
+                        out += ",\"mean\":";
+                        util::appendNumber(out, win->sum[j] / win->count[j]);
+                        out += ",\"last\":";
+                        util::appendNumber(out, win->last[j]);
+                        out += ",\"count\":";
+                        util::appendNumber(out, static_cast<uint64_t>(win->count[j]));
+                        out += '}';
+                    }
+                    if (any) out += "}}";
+                }
+            }
+            if (records == 0) continue;
+
+            const std::string body = std::move(out);
+            out = fmt::format("{{\"bus\":\"{}\",\"window\":{},\"start\":{},\"end\":{},\"messages\":[",
+                              sources_[s].busName, tick, start.count(), end.count());
+            out += body;
+            out += "]}";
+            pub_.Publish("can/" + sources_[s].busName + "/agg", out, opts_.qos);
+        }
+    }
+
+    void Pipeline::wakeAll()
+    {
+        for (auto& w : workers_)
+        {
+            w->wake.fetch_add(1, std::memory_order_release);
+            w->wake.notify_one();
+        }
+    }
+
+    bool Pipeline::readSource(std::size_t source, std::vector<Frame>& batch, bool ready)
+    {
+        const PipelineSource& src = sources_[source];
+        SourceState& state = state_[source];
+        std::size_t count = 0;
+
+        // Ortak epoll thread'i tek kanalın zaman aşımını beklememeli
+        if (!(ready ? src.channel->drain(batch, count) : src.channel->readBatch(batch, count)))
+        {
+            std::cerr << "[Listener] " << src.busName << " okunamıyor, kanal bırakıldı\n";
+            return false;
+        }
+
+        if (count != 0 && !state.firstFrameLogged)
+        {
+            std::cout << "[Listener] " << src.busName << ": ilk frame alındı (id=0x" << std::hex << batch.front().rawId() << std::dec << ")" << std::endl;
+            state.firstFrameLogged = true;
+        }
+        if (uint64_t dropped = src.channel->droppedFrames(); dropped != state.lastDropped)
+        {
+            std::cerr << "[Listener] " << src.busName << ": kernel kuyruğunda " << (dropped - state.lastDropped) << " frame kayboldu (toplam " << dropped << ")\n";
+            state.lastDropped = dropped;
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            batch[i].channel = static_cast<uint8_t>(source);
+            Worker& w = *workers_[route(batch[i])];
+            if (!w.queue.tryPush(batch[i]))
+                w.dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (recorder_ && count != 0)
+            recorder_->record(std::span<const Frame>(batch.data(), count));
+        state.read.fetch_add(count, std::memory_order_relaxed);
+        return true;
+    }
+
+    void Pipeline::readerLoop(std::stop_token st, std::size_t source, bool statsOwner)
+    {
+        std::vector<Frame> batch(bus::kRxBatchSize);
+
+        while (!st.stop_requested() && readSource(source, batch))
+        {
+            // Zaman aşımında da uyandır: işçiler batch penceresini kontrol eder
+            wakeAll();
+            if (statsOwner) maybeLogStats();
+        }
+    }
+
+    void Pipeline::pollLoop(std::stop_token st, std::vector<std::size_t> sources, bool statsOwner)
+    {
+#ifdef __linux__
+        const int ep = epoll_create1(EPOLL_CLOEXEC);
+        if (ep < 0)
+        {
+            std::cerr << "[Listener] epoll_create1: " << std::strerror(errno) << "\n";
+            return;
+        }
+        std::size_t active = 0;
+        for (std::size_t i : sources)
+        {
+            epoll_event ev {};
+            ev.events = EPOLLIN;
+            ev.data.u64 = i;
+            if (epoll_ctl(ep, EPOLL_CTL_ADD, sources_[i].channel->nativeHandle(), &ev) == 0)
+                ++active;
+            else
+                std::cerr << "[Listener] " << sources_[i].busName << " epoll'a eklenemedi: " << std::strerror(errno) << "\n";
+        }
+
+        std::vector<Frame> batch(bus::kRxBatchSize);
+        epoll_event events[16];
+        while (!st.stop_requested() && active != 0)
+        {
+            // Hazır her kanaldan bir batch: yoğun bir kanal diğerlerini aç bırakmaz
+            const int n = epoll_wait(ep, events, static_cast<int>(std::size(events)), 100);
+            if (n < 0 && errno != EINTR)
+            {
+                std::cerr << "[Listener] epoll_wait: " << std::strerror(errno) << "\n";
+                break;
+            }
+            for (int k = 0; k < n; ++k)
+            {
+                const auto i = static_cast<std::size_t>(events[k].data.u64);
+                if (!readSource(i, batch, true))
+                {
+                    epoll_ctl(ep, EPOLL_CTL_DEL, sources_[i].channel->nativeHandle(), nullptr);
+                    --active;
+                }
+            }
+            wakeAll();
+            if (statsOwner) maybeLogStats();
+        }
+        ::close(ep);
+#else
+        (void)st; (void)sources; (void)statsOwner;
+#endif
+    }
+
+    void Pipeline::workerLoop(std::stop_token st, Worker& w, std::size_t index)
+    {
+        // Kanal başına serileştirici/batch durumu: her kanalın DBC'si ve konusu ayrı
+        struct SourceCtx
+        {
+            util::FrameSerializer payload;                 // MQTT: sıkışık
+            util::FrameSerializer console;                 // konsol: isteğe bağlı girintili
+            util::BinaryFrameSerializer packed;            // MQTT: [mqtt] format=binary
+            std::unique_ptr<mqtt::FrameBatcher> batcher;   // her işçinin kendi stream'i ve seq sayacı
+            uint64_t fingerprint;                          // batch'teki kayıtların DBC'si
+            std::unique_ptr<PublishFilter> rules;          // [publish] kuralları (DBC'ye derlenmiş)
+            Aggregator* aggregator;                        // [aggregate] (sahibi Worker)
+            std::unique_ptr<HistoryWriter> history;        // [history]
+        };
+
+        // Çevrim içi: bundan sonra okunan DBC göstericileri synchronize()'ı bekletir
+        w.quiescent.store(epoch_.load());
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        std::vector<SourceCtx> ctx;
+        ctx.reserve(sources_.size());
+        std::size_t maxSignals = 0;
+        for (std::size_t i = 0; i < sources_.size(); ++i)
+        {
+            const dbc::DbcDatabase& db = *state_[i].db.load(std::memory_order_acquire);
+            SourceCtx c {util::FrameSerializer(), util::FrameSerializer(opts_.pretty), util::BinaryFrameSerializer(), nullptr, db.fingerprint(), nullptr,
+                         opts_.aggregate ? w.aggregators[i].get() : nullptr, nullptr};
+            if (opts_.batch_window_ms > 0)
+                c.batcher = std::make_unique<mqtt::FrameBatcher>(sources_[i].busName, std::chrono::milliseconds(opts_.batch_window_ms),
+                                                                 opts_.batch_max_frames,
+                                                                 opts_.binary ? mqtt::PayloadFormat::Binary : mqtt::PayloadFormat::Json,
+                                                                 db.fingerprint(), static_cast<uint16_t>(index));
+            if (!opts_.publish_rules.empty())
+            {
+                c.rules = std::make_unique<PublishFilter>(opts_.publish_rules);
+                c.rules->bind(db, index == 0);
+            }
+            if (c.aggregator)
+                c.aggregator->bind(db, std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch()));
+            if (opts_.history)
+            {
+                c.history = std::make_unique<HistoryWriter>(*opts_.history, sources_[i].busName);
+                c.history->bind(db);
+            }
+            ctx.push_back(std::move(c));
+            maxSignals = std::max(maxSignals, db.maxSignalsPerMessage());
+        }
+
+        dbc::DecodedSignals sigs(maxSignals);
+        std::string topic;
+        topic.reserve(64);
+
+        // J1939 TP birleştirici işçiye özel: havuz ve tamponlar burada bir kez ayrılır
+        std::unique_ptr<bus::J1939Reassembler> tp;
+        if (opts_.j1939_tp)
+            tp = std::make_unique<bus::J1939Reassembler>(opts_.tp_max_sessions, opts_.tp_timeout);
+        auto lastExpire = Clock::now();
+
+        // Son değer tablosu: aynı (kanal, ID) hep bu işçiye geldiği için yerel
+        std::unique_ptr<Conflator> last;
+        if (opts_.dedup != DedupMode::Off)
+            last = std::make_unique<Conflator>(opts_.dedup_table, opts_.heartbeat);
+        const bool conflate = opts_.dedup == DedupMode::Conflate;
+        uint64_t seenTick = tick_.load(std::memory_order_acquire);
+
+        auto flushDue = [&](bool all) {
+            const auto now = Clock::now();
+            for (auto& c : ctx)
+                if (c.batcher && (all || c.batcher->due(now)))
+                    c.batcher->flush(pub_, opts_.qos);
+        };
+
+        // frame başlık alanlarını, payload veriyi taşır (TP'de frame dışında)
+        auto process = [&](const Frame& frame, std::span<const uint8_t> payload) {
+            const PipelineSource& src = sources_[frame.channel];
+            const dbc::DbcDatabase& db = *state_[frame.channel].db.load(std::memory_order_acquire);
+            SourceCtx& c = ctx[frame.channel];
+            if (db.fingerprint() != c.fingerprint)
+            {
+                // DBC değişti: eski indekslerle yazılmış kayıtlar eski fingerprint'le gitsin
+                if (c.batcher)
+                {
+                    c.batcher->flush(pub_, opts_.qos);
+                    c.batcher->setFingerprint(db.fingerprint());
+                }
+                c.fingerprint = db.fingerprint();
+                sigs.reserve(db.maxSignalsPerMessage());
+                if (c.rules) c.rules->bind(db, index == 0);
+                if (c.aggregator)
+                    c.aggregator->bind(db, std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch()));
+                if (c.history) c.history->bind(db);
+            }
+
+            const auto msg = db.resolve(frame.id);
+            if (!db.decode(msg, payload, sigs))
+                sigs.clear();
+            if (c.history)
+                c.history->add(frame, msg, sigs);
+            if (auto* latest = latest_.load(std::memory_order_acquire))
+                latest->update(frame.channel, db, frame, msg, sigs);
+            // Toplama her örneği görür (kurallardan önce); ham yayın istenmiyorsa burada biter
+            if (c.aggregator)
+            {
+                c.aggregator->add(frame, msg, sigs);
+                if (!opts_.aggregate_raw)
+                    return;
+            }
+            // Kurallar yalnızca anlamlı değişimleri bırakır; hiç sinyal kalmadıysa frame gitmez
+            if (c.rules && !c.rules->apply(frame, msg, sigs))
+                return;
+
+            if (echo_.load(std::memory_order_relaxed))
+            {
+                const std::string& text = c.console.serialize(frame, payload, src.busName, db, msg, sigs);
+                std::lock_guard lock(echoMutex_);
+                std::cout << text << '\n';
+            }
+
+            if (c.batcher)
+            {
+                if (!opts_.binary)
+                    c.payload.append(c.batcher->next(), frame, payload, src.busName, db, msg, sigs);
+                else if (!c.packed.append(c.batcher->next(), frame, payload, src.busName, db, msg, sigs))
+                {
+                    c.batcher->discard();
+                    return;
+                }
+                if (c.batcher->commit(Clock::now()))
+                    c.batcher->flush(pub_, opts_.qos);
+                return;
+            }
+
+            const std::string& out = opts_.binary ? c.packed.serialize(frame, payload, src.busName, db, msg, sigs)
+                                                  : c.payload.serialize(frame, payload, src.busName, db, msg, sigs);
+            if (out.empty())
+                return;
+            topic.clear();
+            fmt::format_to(std::back_inserter(topic), "can/{}/{:06X}", src.busName, frame.rawId());
+            pub_.Publish(topic, out, opts_.qos);
+        };
+
+        Frame frame;
+        bus::J1939Reassembler::Message tpMsg;
+        for (;;)
+        {
+            const uint32_t seen = w.wake.load(std::memory_order_acquire);
+            uint64_t done = 0;
+
+            while (w.queue.tryPop(frame))
+            {
+                ++done;
+                if (tp)
+                {
+                    const auto r = tp->feed(frame, tpMsg);
+                    if (r == bus::J1939Reassembler::Result::Complete)
+                    {
+                        Frame head {};
+                        head.id = tpMsg.id;
+                        head.flags = Frame::kExt | Frame::kTp;
+                        head.channel = tpMsg.channel;
+                        head.ts = tpMsg.ts;
+                        process(head, tpMsg.data);
+                    }
+                    if (r != bus::J1939Reassembler::Result::NotTp && !opts_.tp_publish_frames)
+                        continue;
+                }
+                // Değişmeyen tekrar çözülmeden ve serileştirilmeden atlanır
+                if (last && (conflate ? last->store(frame) : !last->changed(frame)))
+                    continue;
+                process(frame, frame.payload());
+            }
+            if (done) w.processed.fetch_add(done, std::memory_order_relaxed);
+
+            if (conflate || opts_.aggregate)
+            {
+                if (const uint64_t t = tick_.load(std::memory_order_acquire); t != seenTick)
+                {
+                    seenTick = t;
+                    const auto now = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch());
+                    if (conflate)
+                        last->drain(now, [&](const Frame& f) { process(f, f.payload()); });
+                    for (auto& c : ctx)
+                        if (c.aggregator) c.aggregator->roll(t, now);
+                }
+            }
+            if (last)
+                w.suppressed.store(last->suppressed(), std::memory_order_relaxed);
+            if (!opts_.publish_rules.empty())
+            {
+                uint64_t n = 0;
+                for (const auto& c : ctx) n += c.rules->suppressedFrames();
+                w.ruleSuppressed.store(n, std::memory_order_relaxed);
+            }
+            if (opts_.binary)
+            {
+                uint64_t n = 0;
+                for (const auto& c : ctx) n += c.packed.rejected();
+                w.unencodable.store(n, std::memory_order_relaxed);
+            }
+
+            if (tp)
+            {
+                // Yarım kalan oturumlar: son TP.DT'den sonra timeout kadar sessizlik
+                const auto now = Clock::now();
+                if (tp->active() != 0 && now - lastExpire >= std::chrono::milliseconds(100))
+                {
+                    tp->expire(std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()));
+                    lastExpire = now;
+                }
+                const auto& ts = tp->stats();
+                w.tpCompleted.store(ts.completed, std::memory_order_relaxed);
+                w.tpFailed.store(ts.timedOut + ts.aborted + ts.noSession + ts.invalid, std::memory_order_relaxed);
+            }
+
+            // Boş hatta da pencere süresi dolunca gönder
+            flushDue(false);
+
+            // Sessiz an: bu noktada hiçbir DBC göstericisi tutulmuyor
+            w.quiescent.store(epoch_.load(), std::memory_order_release);
+
+            if (st.stop_requested())
+            {
+                flushDue(true);
+                w.quiescent.store(kOffline, std::memory_order_release);
+                return;
+            }
+            if (done == 0)
+            {
+                w.quiescent.store(kOffline, std::memory_order_release);
+                w.wake.wait(seen, std::memory_order_acquire);
+                w.quiescent.store(epoch_.load());
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+    }
+
+    void Pipeline::maybeLogStats()
+    {
+        const std::chrono::seconds interval(statsInterval_.load(std::memory_order_relaxed));
+        if (interval.count() <= 0) return;
+        const auto now = Clock::now();
+        if (now - lastStats_ >= interval) logStats(now);
+    }
+
+    void Pipeline::logStats(Clock::time_point now)
+    {
+        const double secs = std::chrono::duration<double>(now - lastStats_).count();
+        const PipelineStats cur = stats();
+        const uint64_t sent = pub_.Stats().sent;
+
+        std::string line = fmt::format("[Pipeline] rx {:.0f} fps (", (cur.read - prevStats_.read) / secs);
+        for (std::size_t i = 0; i < cur.readPerSource.size(); ++i)
+            fmt::format_to(std::back_inserter(line), "{}{} {:.0f}", i ? " " : "", sources_[i].busName,
+                           (cur.readPerSource[i] - prevStats_.readPerSource[i]) / secs);
+        line += ") |";
+        for (std::size_t i = 0; i < cur.processed.size(); ++i)
+            fmt::format_to(std::back_inserter(line), " w{} {:.0f}", i, (cur.processed[i] - prevStats_.processed[i]) / secs);
+        fmt::format_to(std::back_inserter(line), " fps | ring drop {} | mqtt {:.0f} msg/s",
+                       cur.dropped - prevStats_.dropped, (sent - prevSent_) / secs);
+        if (recorder_)
+        {
+            const uint64_t recDropped = recorder_->dropped();
+            fmt::format_to(std::back_inserter(line), " | kayıt {} (drop {})", recorder_->written(), recDropped - prevRecDropped_);
+            prevRecDropped_ = recDropped;
+        }
+        if (opts_.dedup != DedupMode::Off)
+            fmt::format_to(std::back_inserter(line), " | tekrar atlandı {}", cur.suppressed - prevStats_.suppressed);
+        if (!opts_.publish_rules.empty())
+            fmt::format_to(std::back_inserter(line), " | kural atlandı {}", cur.ruleSuppressed - prevStats_.ruleSuppressed);
+        if (cur.unencodable != prevStats_.unencodable)
+            fmt::format_to(std::back_inserter(line), " | ikili biçime sığmayan {}", cur.unencodable - prevStats_.unencodable);
+        if (opts_.j1939_tp && cur.tpCompleted + cur.tpFailed != 0)
+            fmt::format_to(std::back_inserter(line), " | j1939 tp {} (hata {})",
+                           cur.tpCompleted - prevStats_.tpCompleted, cur.tpFailed - prevStats_.tpFailed);
+        std::cout << line << std::endl;
+
+        prevStats_ = cur;
+        prevSent_ = sent;
+        lastStats_ = now;
+    }
+
+} // namespace canmqtt::task
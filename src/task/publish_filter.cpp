@@ -0,0 +1,144 @@
+#include "task/publish_filter.hpp"
+
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+namespace canmqtt::task {
+
+namespace {
+
+std::string_view trim(std::string_view s)
+{
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+    return s;
+}
+
+} // namespace
+
+bool ParsePublishRule(std::string_view text, PublishRule& rule)
+{
+    PublishRule r;
+    while (!text.empty()) {
+        const auto comma = text.find(',');
+        const std::string_view item = trim(text.substr(0, comma));
+        text = comma == std::string_view::npos ? std::string_view{} : text.substr(comma + 1);
+        if (item.empty()) continue;
+
+        const auto eq = item.find('=');
+        if (eq == std::string_view::npos) return false;
+        const std::string_view key = trim(item.substr(0, eq));
+        const std::string value(trim(item.substr(eq + 1)));
+        char* end = nullptr;
+        const double v = std::strtod(value.c_str(), &end);
+        if (value.empty() || *end != '\0' || !(v >= 0.0)) return false;
+
+        if (key == "deadband")    r.deadband = v;
+        else if (key == "pct")    r.deadbandPct = v;
+        else if (key == "min_ms") r.minInterval = std::chrono::microseconds(static_cast<int64_t>(v * 1000));
+        else if (key == "max_ms") r.maxInterval = std::chrono::microseconds(static_cast<int64_t>(v * 1000));
+        else return false;
+    }
+    rule = r;
+    return true;
+}
+
+PublishFilter::PublishFilter(std::vector<PublishRuleSpec> specs)
+    : specs_(std::move(specs))
+{
+}
+
+void PublishFilter::bind(const dbc::DbcDatabase& db, bool report)
+{
+    db_ = &db;
+    rules_.clear();
+    ruleOf_.assign(db.signalCount(), kNoRule);
+    messageHasRule_.assign(db.messages().size(), 0);
+    blocks_.clear();
+    lastValue_.clear();
+    lastUs_.clear();
+
+    // Öncelik: varsayılan < mesaj < sinyal; sonraki seviye öncekini ezer
+    const auto& messages = db.messages();
+    for (int level = 0; level < 3; ++level) {
+        for (const auto& spec : specs_) {
+            const int specLevel = spec.message == "*" ? 0 : spec.signal.empty() ? 1 : 2;
+            if (specLevel != level || rules_.size() >= kNoRule) continue;
+            const auto rule = static_cast<uint16_t>(rules_.size());
+            rules_.push_back(spec.rule);
+
+            std::size_t matched = 0;
+            for (std::size_t mi = 0; mi < messages.size(); ++mi) {
+                const dbc::MessageInfo& m = messages[mi];
+                if (level > 0 && m.name != spec.message) continue;
+                for (uint32_t s = m.first_signal; s < m.first_signal + m.signal_count; ++s) {
+                    if (level == 2 && db.signalName(s) != spec.signal) continue;
+                    ruleOf_[s] = rule;
+                    messageHasRule_[mi] = 1;
+                    ++matched;
+                }
+            }
+            if (report && matched == 0 && level > 0)
+                std::cerr << "[Publish] DBC'de karşılığı yok, kural atlandı: " << spec.message
+                          << (spec.signal.empty() ? "" : ".") << spec.signal << "\n";
+        }
+    }
+}
+
+bool PublishFilter::pass(const PublishRule& r, uint32_t slot, double v, std::chrono::microseconds now)
+{
+    int64_t& last = lastUs_[slot];
+    double& value = lastValue_[slot];
+
+    bool publish;
+    if (last == INT64_MIN) {
+        publish = true;
+    } else {
+        const int64_t elapsed = now.count() - last;
+        if (r.maxInterval.count() > 0 && elapsed >= r.maxInterval.count()) {
+            publish = true;
+        } else if (elapsed < r.minInterval.count()) {
+            publish = false;
+        } else if (r.deadband == 0.0 && r.deadbandPct == 0.0) {
+            publish = !(v == value);
+        } else {
+            const double delta = std::abs(v - value);
+            publish = delta > r.deadband && delta > std::abs(value) * r.deadbandPct / 100.0;
+        }
+    }
+    if (publish) {
+        last = now.count();
+        value = v;
+    }
+    return publish;
+}
+
+bool PublishFilter::apply(const bus::Frame& frame, dbc::MessageHandle msg, dbc::DecodedSignals& sigs)
+{
+    if (!msg || sigs.empty() || !db_) return true;
+    const auto mi = static_cast<std::size_t>(msg - db_->messages().data());
+    if (mi >= messageHasRule_.size() || !messageHasRule_[mi]) return true;
+
+    // (kanal, ID) başına ilk görüşte signal_count'luk blok
+    const uint64_t key = (uint64_t{frame.channel} << 32) | frame.rawId();
+    auto [it, inserted] = blocks_.try_emplace(key, static_cast<uint32_t>(lastValue_.size()));
+    if (inserted) {
+        lastValue_.resize(lastValue_.size() + msg->signal_count, 0.0);
+        lastUs_.resize(lastUs_.size() + msg->signal_count, INT64_MIN);
+    }
+    const uint32_t base = it->second;
+
+    const std::size_t before = sigs.size();
+    sigs.retain([&](uint32_t index, double v) {
+        const uint16_t rule = ruleOf_[index];
+        return rule == kNoRule || pass(rules_[rule], base + (index - msg->first_signal), v, frame.ts);
+    });
+    suppressedSignals_ += before - sigs.size();
+    if (!sigs.empty()) return true;
+    ++suppressedFrames_;
+    return false;
+}
+
+} // namespace canmqtt::task
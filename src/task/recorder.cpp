@@ -0,0 +1,287 @@
+#include "task/recorder.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <fmt/core.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace canmqtt::task
+{
+
+    using bus::Frame;
+    using Clock = std::chrono::steady_clock;
+    namespace cap = util::capture;
+    namespace fs = std::filesystem;
+
+    namespace
+    {
+        int64_t nowUs(auto tp)
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(tp.time_since_epoch()).count();
+        }
+
+        constexpr std::size_t kPage = 4096;
+    }
+
+    Recorder::Recorder(const RecorderOptions& opts, std::vector<std::string> channelNames)
+        : opts_(opts), channelNames_(std::move(channelNames)), queue_(opts.queue_size)
+    {
+        opts_.segment_mb     = std::max<std::size_t>(opts_.segment_mb, 1);
+        opts_.index_interval = std::max<uint32_t>(opts_.index_interval, 1);
+    }
+
+    Recorder::~Recorder()
+    {
+        stop();
+    }
+
+    bool Recorder::start()
+    {
+#ifdef _WIN32
+        std::cerr << "[Recorder] Bu platformda desteklenmiyor\n";
+        return false;
+#else
+        std::error_code ec;
+        fs::create_directories(opts_.dir, ec);
+        if (ec)
+        {
+            std::cerr << "[Recorder] Dizin oluşturulamadı: " << opts_.dir << " (" << ec.message() << ")\n";
+            return false;
+        }
+
+        // Önceki çalıştırmaların segmentleri de saklama sınırına dahil (ad sırası = zaman sırası)
+        for (const auto& e : fs::directory_iterator(opts_.dir, ec))
+        {
+            const std::string name = e.path().filename().string();
+            if (e.is_regular_file() && name.starts_with(opts_.prefix + "_") && name.ends_with(".vcap"))
+                segments_.push_back(e.path().string());
+        }
+        std::sort(segments_.begin(), segments_.end());
+
+        if (!openSegment()) return false;
+        writer_ = std::jthread([this](std::stop_token st) { writerLoop(st); });
+        return true;
+#endif
+    }
+
+    void Recorder::stop()
+    {
+        if (!writer_.joinable()) return;
+        writer_.request_stop();
+        writer_.join();
+    }
+
+    void Recorder::record(std::span<const Frame> frames)
+    {
+        for (const Frame& f : frames)
+            if (!queue_.tryPush(f))
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Recorder::writerLoop(std::stop_token st)
+    {
+        auto lastFlush = Clock::now();
+        Frame frame;
+        for (;;)
+        {
+            std::size_t n = 0;
+            while (queue_.tryPop(frame))
+            {
+                if (!append(frame))
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                ++n;
+            }
+
+            const auto now = Clock::now();
+            if (now - lastFlush >= opts_.flush_interval)
+            {
+                flush();
+                lastFlush = now;
+            }
+            if (st.stop_requested()) break;
+            // Tam yükte (~8 kfps) 5 ms'de ~40 frame birikir; okuyucuya uyandırma maliyeti yüklenmez
+            if (n == 0) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        // Okuyucular durduktan sonra kalanlar
+        while (queue_.tryPop(frame))
+            if (!append(frame))
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+        closeSegment();
+    }
+
+    bool Recorder::openSegment()
+    {
+#ifdef _WIN32
+        return false;
+#else
+        char stamp[32];
+        const std::time_t t = std::time(nullptr);
+        std::tm tm {};
+        localtime_r(&t, &tm);
+        std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &tm);
+        const std::string path = (fs::path(opts_.dir) / fmt::format("{}_{}_{:04}.vcap", opts_.prefix, stamp, sequence_)).string();
+
+        const std::size_t size = opts_.segment_mb << 20;
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            std::cerr << "[Recorder] " << path << " açılamadı: " << std::strerror(errno) << "\n";
+            return false;
+        }
+        // Blokları baştan ayır: yazarken SD kartta tahsis/parçalanma ve ENOSPC sürprizi olmaz
+        if (const int err = posix_fallocate(fd, 0, static_cast<off_t>(size)); err != 0)
+        {
+            std::cerr << "[Recorder] " << path << " için " << opts_.segment_mb << " MB ayrılamadı: " << std::strerror(err) << "\n";
+            ::close(fd);
+            ::unlink(path.c_str());
+            return false;
+        }
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED)
+        {
+            std::cerr << "[Recorder] mmap: " << std::strerror(errno) << "\n";
+            ::close(fd);
+            return false;
+        }
+        ::madvise(p, size, MADV_SEQUENTIAL);
+
+        fd_ = fd;
+        map_ = static_cast<uint8_t*>(p);
+        mapSize_ = size;
+
+        // Bloğu en küçük kayıtlarla dolduran yazıcıya bile yetecek kadar indeks girdisi
+        const std::size_t perEntry = opts_.index_interval * cap::recordSize(0) + sizeof(cap::IndexEntry);
+        const std::size_t capacity = (size - cap::kDataOffset) / perEntry + 1;
+        dataLimit_ = size - capacity * sizeof(cap::IndexEntry);
+
+        auto& h = *reinterpret_cast<cap::FileHeader*>(map_);
+        std::memcpy(h.magic, cap::kMagic, sizeof(h.magic));
+        h.version       = cap::kVersion;
+        h.headerSize    = sizeof(cap::FileHeader);
+        h.indexInterval = opts_.index_interval;
+        h.segmentSize   = size;
+        h.wallStartUs   = nowUs(std::chrono::system_clock::now());
+        h.steadyStartUs = nowUs(Clock::now());
+        h.dataEnd       = cap::kDataOffset;
+        h.indexOffset   = dataLimit_;
+        h.indexCapacity = static_cast<uint32_t>(capacity);
+        h.sequence      = sequence_++;
+
+        std::size_t at = sizeof(cap::FileHeader);
+        for (const auto& name : channelNames_)
+        {
+            if (at + name.size() + 1 > cap::kDataOffset) break;
+            std::memcpy(map_ + at, name.c_str(), name.size() + 1);
+            at += name.size() + 1;
+            ++h.channelCount;
+        }
+
+        offset_ = cap::kDataOffset;
+        flushedUpTo_ = 0;
+        flushedIndex_ = 0;
+        block_ = {};
+
+        segments_.push_back(path);
+        pruneSegments();
+        std::cout << "[Recorder] Segment: " << path << std::endl;
+        return true;
+#endif
+    }
+
+    void Recorder::closeSegment()
+    {
+#ifndef _WIN32
+        if (!map_) return;
+        closeIndexBlock();
+        flush();
+        ::munmap(map_, mapSize_);
+        ::close(fd_);
+        map_ = nullptr;
+        fd_ = -1;
+#endif
+    }
+
+    bool Recorder::append(const Frame& frame)
+    {
+        if (!map_) return false;
+        const std::size_t size = cap::recordSize(frame.len);
+        auto* h = reinterpret_cast<cap::FileHeader*>(map_);
+        if (offset_ + size > dataLimit_ || h->indexCount == h->indexCapacity)
+        {
+            closeSegment();
+            if (!openSegment()) return false;
+            h = reinterpret_cast<cap::FileHeader*>(map_);
+        }
+
+        const cap::RecordHeader rec {frame.ts.count(), frame.rawId(), frame.channel, frame.flags, frame.len, 0};
+        std::memcpy(map_ + offset_, &rec, sizeof(rec));
+        std::memcpy(map_ + offset_ + sizeof(rec), frame.data, frame.len);   // dolgu baytları zaten sıfır
+
+        if (block_.count == 0)
+        {
+            block_.firstTsUs = rec.tsUs;
+            block_.offset = offset_;
+        }
+        block_.lastTsUs = rec.tsUs;
+        cap::bloomAdd(block_.idBloom, rec.rawId);
+        if (++block_.count == opts_.index_interval) closeIndexBlock();
+
+        offset_ += size;
+        ++h->recordCount;
+        written_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void Recorder::closeIndexBlock()
+    {
+        if (block_.count == 0) return;
+        auto& h = *reinterpret_cast<cap::FileHeader*>(map_);
+        std::memcpy(map_ + h.indexOffset + std::size_t{h.indexCount} * sizeof(cap::IndexEntry), &block_, sizeof(block_));
+        ++h.indexCount;
+        block_ = {};
+    }
+
+    void Recorder::flush()
+    {
+#ifndef _WIN32
+        if (!map_) return;
+        auto& h = *reinterpret_cast<cap::FileHeader*>(map_);
+        h.dataEnd = offset_;
+
+        // MS_ASYNC: kirli sayfaları yazmaya işaretler, beklemez
+        const std::size_t from = flushedUpTo_ & ~(kPage - 1);
+        ::msync(map_, kPage, MS_ASYNC);
+        if (offset_ > from)
+            ::msync(map_ + from, offset_ - from, MS_ASYNC);
+        if (h.indexCount > flushedIndex_)
+        {
+            const std::size_t first = (h.indexOffset + std::size_t{flushedIndex_} * sizeof(cap::IndexEntry)) & ~(kPage - 1);
+            const std::size_t end   = h.indexOffset + std::size_t{h.indexCount} * sizeof(cap::IndexEntry);
+            ::msync(map_ + first, end - first, MS_ASYNC);
+        }
+        flushedUpTo_ = offset_;
+        flushedIndex_ = h.indexCount;
+#endif
+    }
+
+    void Recorder::pruneSegments()
+    {
+        if (opts_.max_segments == 0) return;
+        while (segments_.size() > opts_.max_segments)
+        {
+            std::error_code ec;
+            fs::remove(segments_.front(), ec);
+            segments_.erase(segments_.begin());
+        }
+    }
+
+} // namespace canmqtt::task
@@ -0,0 +1,206 @@
+#include "task/signal_history.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace canmqtt::task {
+
+namespace {
+
+std::string seriesKey(std::string_view bus, uint32_t canId, std::string_view signal)
+{
+    std::string key(bus);
+    key += '/';
+    key += std::to_string(canId);
+    key += '/';
+    key += signal;
+    return key;
+}
+
+} // namespace
+
+SignalHistory& SignalHistory::getInstance()
+{
+    static absl::NoDestructor<SignalHistory> instance;
+    return *instance;
+}
+
+bool SignalHistory::init(const HistoryOptions& opts)
+{
+    if (enabled()) return true;
+    if (opts.depth == 0 || opts.memory_mb == 0) return false;
+
+    const std::size_t perSeries = opts.depth * (sizeof(int64_t) + sizeof(double)) + sizeof(Ring);
+    const std::size_t capacity = (opts.memory_mb << 20) / perSeries;
+    if (capacity == 0) {
+        std::cerr << "[History] memory_mb bir sinyalin halkasına (depth=" << opts.depth << ") yetmiyor\n";
+        return false;
+    }
+
+    // Sayfalar ilk yazımda gelir: ayrılmamış seriler fiziksel bellek tutmaz
+    depth_ = opts.depth;
+    rings_ = std::make_unique<Ring[]>(capacity);
+    ts_ = std::make_unique_for_overwrite<int64_t[]>(capacity * depth_);
+    value_ = std::make_unique_for_overwrite<double[]>(capacity * depth_);
+    capacity_ = capacity;
+    std::cout << "[History] " << capacity << " sinyal x " << depth_ << " örnek (" << opts.memory_mb << " MB)" << std::endl;
+    return true;
+}
+
+SignalHistory::Series SignalHistory::allocate(std::string_view bus, uint32_t canId, std::string_view message,
+                                              std::string_view signal)
+{
+    std::lock_guard lock(mutex_);
+    auto key = seriesKey(bus, canId, signal);
+    if (auto it = byKey_.find(key); it != byKey_.end()) return it->second;
+
+    const Series s = count_.load(std::memory_order_relaxed);
+    if (s >= capacity_) return kNone;
+    info_.push_back({s, std::string(bus), canId, std::string(message), std::string(signal)});
+    byKey_.emplace(std::move(key), s);
+    count_.store(s + 1, std::memory_order_release);
+    return s;
+}
+
+void SignalHistory::append(Series s, std::chrono::microseconds ts, double value)
+{
+    Ring& r = rings_[s];
+    const uint64_t h = r.head.load(std::memory_order_relaxed);
+    const std::size_t at = s * depth_ + h % depth_;
+
+    // Seqlock: indeks, eski örnek ezilmeden önce duyurulur
+    r.claim.store(h + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::atomic_ref<int64_t>(ts_[at]).store(ts.count(), std::memory_order_relaxed);
+    std::atomic_ref<double>(value_[at]).store(value, std::memory_order_relaxed);
+    r.head.store(h + 1, std::memory_order_release);
+}
+
+std::vector<SignalHistory::SeriesInfo> SignalHistory::list() const
+{
+    std::lock_guard lock(mutex_);
+    return info_;
+}
+
+SignalHistory::Series SignalHistory::find(std::string_view bus, std::string_view message, std::string_view signal) const
+{
+    std::lock_guard lock(mutex_);
+    for (const auto& i : info_)
+        if ((bus.empty() || i.bus == bus) && i.message == message && i.signal == signal) return i.id;
+    return kNone;
+}
+
+std::size_t SignalHistory::range(Series s, std::chrono::microseconds from, std::chrono::microseconds to,
+                                 std::vector<Sample>& out) const
+{
+    out.clear();
+    if (s >= count_.load(std::memory_order_acquire)) return 0;
+
+    const Ring& r = rings_[s];
+    const std::size_t base = s * depth_;
+    auto tsAt = [&](uint64_t i) {
+        return std::atomic_ref<int64_t>(ts_[base + i % depth_]).load(std::memory_order_relaxed);
+    };
+
+    const uint64_t head = r.head.load(std::memory_order_acquire);
+    uint64_t lo = head > depth_ ? head - depth_ : 0;
+
+    // İlk ts >= from (halka zaman sıralı)
+    for (uint64_t hi = head; lo < hi;) {
+        const uint64_t mid = lo + (hi - lo) / 2;
+        if (tsAt(mid) < from.count()) lo = mid + 1;
+        else hi = mid;
+    }
+    const uint64_t first = lo;
+    for (uint64_t i = first; i < head; ++i) {
+        const int64_t t = tsAt(i);
+        if (t > to.count()) break;
+        out.push_back({std::chrono::microseconds(t),
+                       std::atomic_ref<double>(value_[base + i % depth_]).load(std::memory_order_relaxed)});
+    }
+
+    // Kopyalarken yazarın ezmiş olabileceği baştaki örnekler atılır
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t claim = r.claim.load(std::memory_order_relaxed);
+    const uint64_t valid = claim > depth_ ? claim - depth_ : 0;
+    if (first < valid)
+        out.erase(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(std::min<uint64_t>(valid - first, out.size())));
+    return out.size();
+}
+
+std::size_t SignalHistory::downsample(Series s, std::chrono::microseconds from, std::chrono::microseconds to,
+                                      std::size_t buckets, std::vector<Bucket>& out) const
+{
+    out.clear();
+    thread_local std::vector<Sample> samples;
+    if (buckets == 0 || to < from || range(s, from, to, samples) == 0) return 0;
+
+    const double width = static_cast<double>((to - from).count() + 1) / static_cast<double>(buckets);
+    std::size_t current = std::numeric_limits<std::size_t>::max();
+    double sum = 0.0;
+    for (const Sample& x : samples) {
+        const auto k = std::min(buckets - 1, static_cast<std::size_t>((x.ts - from).count() / width));
+        if (k != current) {
+            if (!out.empty()) out.back().mean = sum / out.back().count;
+            out.push_back({x.ts, x.value, x.value, 0.0, x.value, 0});
+            current = k;
+            sum = 0.0;
+        }
+        Bucket& b = out.back();
+        b.min = std::min(b.min, x.value);
+        b.max = std::max(b.max, x.value);
+        b.last = x.value;
+        ++b.count;
+        sum += x.value;
+    }
+    out.back().mean = sum / out.back().count;
+    return out.size();
+}
+
+bool SignalHistory::latest(Series s, Sample& out) const
+{
+    if (s >= count_.load(std::memory_order_acquire)) return false;
+    const Ring& r = rings_[s];
+    for (;;) {
+        const uint64_t head = r.head.load(std::memory_order_acquire);
+        if (head == 0) return false;
+        const std::size_t at = s * depth_ + (head - 1) % depth_;
+        out.ts = std::chrono::microseconds(std::atomic_ref<int64_t>(ts_[at]).load(std::memory_order_relaxed));
+        out.value = std::atomic_ref<double>(value_[at]).load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (r.claim.load(std::memory_order_relaxed) < head + depth_) return true;
+    }
+}
+
+HistoryWriter::HistoryWriter(SignalHistory& history, std::string bus)
+    : history_(history), bus_(std::move(bus))
+{
+}
+
+void HistoryWriter::bind(const dbc::DbcDatabase& db)
+{
+    db_ = &db;
+    blocks_.clear();
+    series_.clear();
+}
+
+void HistoryWriter::add(const bus::Frame& frame, dbc::MessageHandle msg, const dbc::DecodedSignals& sigs)
+{
+    if (!msg || sigs.empty() || !db_) return;
+
+    // (kanal, ID) ilk görüldüğünde sinyallerin serileri bir kez kilitle bulunur
+    auto [it, inserted] = blocks_.try_emplace(frame.rawId(), static_cast<uint32_t>(series_.size()));
+    if (inserted) {
+        for (uint32_t k = 0; k < msg->signal_count; ++k)
+            series_.push_back(history_.allocate(bus_, frame.rawId(), msg->name, db_->signalName(msg->first_signal + k)));
+    }
+    const uint32_t block = it->second;
+
+    for (std::size_t k = 0; k < sigs.size(); ++k) {
+        const SignalHistory::Series s = series_[block + (sigs.index(k) - msg->first_signal)];
+        if (s != SignalHistory::kNone) history_.append(s, frame.ts, sigs.value(k));
+    }
+}
+
+} // namespace canmqtt::task
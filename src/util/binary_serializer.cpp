@@ -0,0 +1,173 @@
+#include "util/binary_serializer.hpp"
+#include "util/frame_serializer.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace canmqtt::util {
+
+namespace binary {
+
+void putU16(std::string& out, uint16_t v)
+{
+    const char b[2] = {char(v), char(v >> 8)};
+    out.append(b, sizeof(b));
+}
+
+void putU32(std::string& out, uint32_t v)
+{
+    const char b[4] = {char(v), char(v >> 8), char(v >> 16), char(v >> 24)};
+    out.append(b, sizeof(b));
+}
+
+void putU64(std::string& out, uint64_t v)
+{
+    putU32(out, static_cast<uint32_t>(v));
+    putU32(out, static_cast<uint32_t>(v >> 32));
+}
+
+void writeU16(std::string& out, std::size_t at, uint16_t v)
+{
+    out[at]     = char(v);
+    out[at + 1] = char(v >> 8);
+}
+
+void putHeader(std::string& out, uint8_t kind, uint64_t fingerprint)
+{
+    const char h[4] = {char(kMagic0), char(kMagic1), char(kVersion), char(kind)};
+    out.append(h, sizeof(h));
+    putU32(out, static_cast<uint32_t>(fingerprint));
+}
+
+} // namespace binary
+
+BinaryFrameSerializer::BinaryFrameSerializer()
+{
+    buf_.reserve(1024);
+}
+
+const std::string& BinaryFrameSerializer::serialize(const bus::Frame& frame,
+                                                    std::string_view busName,
+                                                    const dbc::DbcDatabase& db,
+                                                    dbc::MessageHandle msg,
+                                                    const dbc::DecodedSignals& sigs)
+{
+    buf_.clear();
+    binary::putHeader(buf_, binary::kKindFrame, db.fingerprint());
+    if (!append(buf_, frame, busName, db, msg, sigs))
+        buf_.clear();
+    return buf_;
+}
+
+const std::string& BinaryFrameSerializer::serialize(const bus::Frame& frame,
+                                                    std::span<const uint8_t> payload,
+                                                    std::string_view busName,
+                                                    const dbc::DbcDatabase& db,
+                                                    dbc::MessageHandle msg,
+                                                    const dbc::DecodedSignals& sigs)
+{
+    buf_.clear();
+    binary::putHeader(buf_, binary::kKindFrame, db.fingerprint());
+    if (!append(buf_, frame, payload, busName, db, msg, sigs))
+        buf_.clear();
+    return buf_;
+}
+
+bool BinaryFrameSerializer::append(std::string& out,
+                                   const bus::Frame& frame,
+                                   std::string_view busName,
+                                   const dbc::DbcDatabase& db,
+                                   dbc::MessageHandle msg,
+                                   const dbc::DecodedSignals& sigs)
+{
+    return append(out, frame, frame.payload(), busName, db, msg, sigs);
+}
+
+bool BinaryFrameSerializer::reject(const bus::Frame& frame, const char* reason)
+{
+    if (rejected_++ == 0)
+        std::cerr << "[Binary] ID " << std::hex << frame.rawId() << std::dec << " ikili biçime sığmıyor (" << reason
+                  << "), kayıt yayınlanmadı; sonrakiler yalnızca sayılır\n";
+    return false;
+}
+
+bool BinaryFrameSerializer::append(std::string& out,
+                                   const bus::Frame& frame,
+                                   std::span<const uint8_t> payload,
+                                   std::string_view /*busName: konu içinde*/,
+                                   const dbc::DbcDatabase& db,
+                                   dbc::MessageHandle msg,
+                                   const dbc::DecodedSignals& sigs)
+{
+    using namespace binary;
+    const std::size_t nsig = sigs.size();
+    // TP mesajları 255 baytı aşabilir: uzunluk u8 yerine ayrı u16 alanda
+    const bool tp = frame.flags & kFlagTp;
+
+    // Sınırlar yazmadan önce denetlenir: kısmi kayıt tampona hiç girmez
+    if (nsig > kMaxSignals) return reject(frame, "mesajda 255'ten fazla sinyal");
+    if (msg && static_cast<std::size_t>(msg - db.messages().data()) >= kNoMessage)
+        return reject(frame, "mesaj indeksi 0xFFFF'i aşıyor");
+    if (!tp && payload.size() > 0xFF) return reject(frame, "payload 255 baytı aşıyor");
+    std::size_t size = 18 + (tp ? 2 : 0) + payload.size();
+    for (std::size_t i = 0; i < nsig; ++i) {
+        if (sigs.index(i) > kMaxSignalIndex) return reject(frame, "sinyal indeksi 0x7FFF'i aşıyor");
+        const double v = sigs.value(i);
+        size += static_cast<double>(static_cast<float>(v)) == v || std::isnan(v) ? 6 : 10;
+    }
+    if (size > kMaxRecordSize) return reject(frame, "kayıt 65535 baytı aşıyor");
+
+    putU64(out, static_cast<uint64_t>(frame.ts.count()));
+    putU32(out, frame.rawId());
+    putU16(out, msg ? static_cast<uint16_t>(msg - db.messages().data()) : kNoMessage);
+    const char meta[4] = {char(frame.flags), char(frame.channel), char(tp ? 0 : payload.size()), char(nsig)};
+    out.append(meta, sizeof(meta));
+    if (tp) putU16(out, static_cast<uint16_t>(payload.size()));
+    out.append(reinterpret_cast<const char*>(payload.data()), payload.size());
+
+    // Değer f32'de kayıpsız temsil edilebiliyorsa 4 bayt, değilse f64
+    for (std::size_t i = 0; i < nsig; ++i) {
+        const double v = sigs.value(i);
+        const float  f = static_cast<float>(v);
+        const auto idx = static_cast<uint16_t>(sigs.index(i));
+        if (static_cast<double>(f) == v || std::isnan(v)) {
+            putU16(out, idx);
+            putU32(out, std::bit_cast<uint32_t>(f));
+        } else {
+            putU16(out, idx | kValueF64);
+            putU64(out, std::bit_cast<uint64_t>(v));
+        }
+    }
+    return true;
+}
+
+std::string BuildSchemaJson(const dbc::DbcDatabase& db)
+{
+    std::string out;
+    out.reserve(64 * 1024);
+    out += "{\"version\":";
+    appendNumber(out, static_cast<uint64_t>(binary::kVersion));
+    out += ",\"fingerprint\":";
+    appendNumber(out, static_cast<uint64_t>(static_cast<uint32_t>(db.fingerprint())));
+    out += ",\"messages\":[";
+    const auto& msgs = db.messages();
+    for (std::size_t i = 0; i < msgs.size(); ++i) {
+        if (i) out += ',';
+        out += '"';
+        appendEscaped(out, msgs[i].name);
+        out += '"';
+    }
+    out += "],\"signals\":[";
+    for (uint32_t i = 0; i < db.signalCount(); ++i) {
+        if (i) out += ',';
+        out += '"';
+        appendEscaped(out, db.signalName(i));
+        out += '"';
+    }
+    out += "]}";
+    return out;
+}
+
+} // namespace canmqtt::util
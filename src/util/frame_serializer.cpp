@@ -0,0 +1,176 @@
+#include "util/frame_serializer.hpp"
+
+#include <charconv>
+#include <cmath>
+
+namespace canmqtt::util {
+
+namespace {
+
+// Önceden hazırlanmış anahtar parçaları: [0] = sıkışık, [1] = girintili
+struct Keys {
+    std::string_view open, ts, bus, id, dlc, raw, name, signals, sigSep, sigOpen, sigClose, close;
+};
+constexpr Keys kKeys[2] = {
+    {"{", "\"ts\":", ",\"bus\":\"", "\",\"id\":", ",\"dlc\":", ",\"raw\":\"",
+     "\",\"name\":\"", "\",\"signals\":", ",", "{", "}", "}"},
+    {"{\n", "  \"ts\": ", ",\n  \"bus\": \"", "\",\n  \"id\": ", ",\n  \"dlc\": ", ",\n  \"raw\": \"",
+     "\",\n  \"name\": \"", "\",\n  \"signals\": ", ",\n    ", "{\n    ", "\n  }", "\n}"},
+};
+
+constexpr char kHex[] = "0123456789ABCDEF";
+
+} // namespace
+
+void appendEscaped(std::string& out, std::string_view s)
+{
+    for (char c : s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n";  break;
+            case '\r': out += "\\r";  break;
+            case '\t': out += "\\t";  break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out += "\\u00";
+                    out += kHex[(c >> 4) & 0xF];
+                    out += kHex[c & 0xF];
+                } else {
+                    out += c;
+                }
+        }
+    }
+}
+
+void appendNumber(std::string& out, double v)
+{
+    if (!std::isfinite(v)) { out += "null"; return; }
+    char tmp[32];
+    auto r = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    out.append(tmp, r.ptr);
+}
+
+void appendNumber(std::string& out, int64_t v)
+{
+    char tmp[24];
+    auto r = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    out.append(tmp, r.ptr);
+}
+
+void appendNumber(std::string& out, uint64_t v)
+{
+    char tmp[24];
+    auto r = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    out.append(tmp, r.ptr);
+}
+
+void appendHex(std::string& out, const uint8_t* d, std::size_t len)
+{
+    if (len == 0) return;
+    const std::size_t at = out.size();
+    out.resize(at + len * 3 - 1);
+    char* p = out.data() + at;
+    for (std::size_t i = 0; i < len; ++i) {
+        if (i) *p++ = ' ';
+        *p++ = kHex[d[i] >> 4];
+        *p++ = kHex[d[i] & 0xF];
+    }
+}
+
+FrameSerializer::FrameSerializer(bool pretty) : pretty_(pretty)
+{
+    buf_.reserve(4096);
+}
+
+void FrameSerializer::bind(const dbc::DbcDatabase& db)
+{
+    // Sinyal anahtarları DBC başına bir kez hazırlanır
+    bound_ = &db;
+    boundFingerprint_ = db.fingerprint();
+    sigKeys_.clear();
+    sigKeys_.reserve(db.signalCount());
+    for (uint32_t i = 0; i < db.signalCount(); ++i) {
+        std::string key = "\"";
+        appendEscaped(key, db.signalName(i));
+        key += "\"";
+        sigKeys_.push_back(std::move(key));
+    }
+}
+
+const std::string& FrameSerializer::serialize(const bus::Frame& frame,
+                                              std::string_view busName,
+                                              const dbc::DbcDatabase& db,
+                                              dbc::MessageHandle msg,
+                                              const dbc::DecodedSignals& sigs)
+{
+    buf_.clear();
+    append(buf_, frame, busName, db, msg, sigs);
+    return buf_;
+}
+
+const std::string& FrameSerializer::serialize(const bus::Frame& frame,
+                                              std::span<const uint8_t> payload,
+                                              std::string_view busName,
+                                              const dbc::DbcDatabase& db,
+                                              dbc::MessageHandle msg,
+                                              const dbc::DecodedSignals& sigs)
+{
+    buf_.clear();
+    append(buf_, frame, payload, busName, db, msg, sigs);
+    return buf_;
+}
+
+void FrameSerializer::append(std::string& out,
+                             const bus::Frame& frame,
+                             std::string_view busName,
+                             const dbc::DbcDatabase& db,
+                             dbc::MessageHandle msg,
+                             const dbc::DecodedSignals& sigs)
+{
+    append(out, frame, frame.payload(), busName, db, msg, sigs);
+}
+
+void FrameSerializer::append(std::string& out,
+                             const bus::Frame& frame,
+                             std::span<const uint8_t> payload,
+                             std::string_view busName,
+                             const dbc::DbcDatabase& db,
+                             dbc::MessageHandle msg,
+                             const dbc::DecodedSignals& sigs)
+{
+    // Adres tek başına yetmez: hot reload'da yeni DBC eskisinin yerinde oluşabilir
+    if (bound_ != &db || boundFingerprint_ != db.fingerprint()) bind(db);
+    const Keys& k = kKeys[pretty_ ? 1 : 0];
+
+    out += k.open;
+    out += k.ts;
+    appendNumber(out, static_cast<int64_t>(frame.ts.count()));
+    out += k.bus;
+    appendEscaped(out, busName);
+    out += k.id;
+    appendNumber(out, static_cast<uint64_t>(frame.rawId()));
+    out += k.dlc;
+    appendNumber(out, static_cast<uint64_t>(payload.size()));
+    out += k.raw;
+    appendHex(out, payload.data(), payload.size());
+    out += k.name;
+    if (msg) appendEscaped(out, msg->name);
+
+    if (sigs.empty()) {
+        out += '"';
+    } else {
+        out += k.signals;
+        out += k.sigOpen;
+        for (std::size_t i = 0; i < sigs.size(); ++i) {
+            if (i) out += k.sigSep;
+            out += sigKeys_[sigs.index(i)];
+            out += pretty_ ? ": " : ":";
+            appendNumber(out, sigs.value(i));
+        }
+        out += k.sigClose;
+    }
+    out += k.close;
+}
+
+} // namespace canmqtt::util
@@ -0,0 +1,185 @@
+// tools/vscan_bench.cpp
+// Frame başına çözme + JSON serileştirme maliyetini ölçer: FrameSerializer
+// (dinleyicinin kullandığı yol) ile eski nlohmann::json kurulumu + dump(2)
+// aynı işle karşılaştırılır: yalnız MQTT kaydı ve MQTT + konsol kaydı.
+// Frame'ler DBC'den vscan_gen ile aynı encode yoluyla üretilir; her iki yol
+// da resolve + decode içerir.
+//
+//   vscan_bench -d conf/j1939.dbc [-m EEC1,CCVS1] [-n 200000]
+#include "dbc/dbc_database.hpp"
+#include "util/frame_serializer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fmt/core.h>
+#include <nlohmann/json.hpp>
+
+namespace bus = canmqtt::bus;
+namespace dbc = canmqtt::dbc;
+namespace util = canmqtt::util;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Options {
+    std::string dbcFile = "../conf/j1939.dbc";
+    std::vector<std::string> messages;      ///< boş: DBC'deki tüm mesajlar
+    std::size_t iterations = 200000;
+};
+
+void usage()
+{
+    std::cerr <<
+        "Kullanım: vscan_bench [seçenekler]\n"
+        "  -d <dbc>        DBC dosyası\n"
+        "  -m <a,b,..>     ölçülecek mesaj adları (varsayılan: hepsi)\n"
+        "  -n <adet>       yol başına frame sayısı (varsayılan 200000)\n";
+}
+
+std::vector<std::string> splitList(std::string_view s)
+{
+    std::vector<std::string> out;
+    while (!s.empty()) {
+        const auto comma = s.find(',');
+        if (comma != 0) out.emplace_back(s.substr(0, comma));
+        if (comma == std::string_view::npos) break;
+        s.remove_prefix(comma + 1);
+    }
+    return out;
+}
+
+bool parseArgs(int argc, char** argv, Options& o)
+{
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view a = argv[i];
+            if (a == "-h" || a == "--help") return false;
+            if (i + 1 >= argc) return false;
+            const std::string v = argv[++i];
+            if      (a == "-d") o.dbcFile = v;
+            else if (a == "-m") o.messages = splitList(v);
+            else if (a == "-n") o.iterations = std::stoul(v);
+            else return false;
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return o.iterations > 0;
+}
+
+// Eski util/json_utils.inl'deki hex biçimlendirme (karşılaştırma için aynen)
+std::string toHex(const uint8_t* d, std::size_t len)
+{
+    std::ostringstream oss;
+    oss << std::uppercase << std::hex << std::setfill('0');
+    for (std::size_t i = 0; i < len; ++i) {
+        oss << std::setw(2) << int(d[i]);
+        if (i + 1 < len) oss << ' ';
+    }
+    return oss.str();
+}
+
+double nsPerFrame(Clock::duration d, std::size_t n)
+{
+    return std::chrono::duration<double, std::nano>(d).count() / static_cast<double>(n);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        usage();
+        return 2;
+    }
+
+    dbc::DbcDatabase db;
+    if (!db.load(opt.dbcFile)) return 1;
+
+    // Her mesaj için aralık ortasındaki değerlerle bir frame
+    std::vector<bus::Frame> frames;
+    std::vector<double> values(db.maxSignalsPerMessage());
+    for (const auto& m : db.messages()) {
+        if (!opt.messages.empty() && std::find(opt.messages.begin(), opt.messages.end(), m.name) == opt.messages.end())
+            continue;
+        for (uint32_t s = 0; s < m.signal_count; ++s) {
+            const auto [lo, hi] = db.plan().range(m.first_signal + s);
+            values[s] = lo + (hi - lo) * 0.5;
+        }
+        bus::Frame f {};
+        f.id = m.id;
+        f.len = static_cast<uint8_t>(std::min<std::size_t>(m.size, sizeof(f.data)));
+        if (m.extended) f.flags |= bus::Frame::kExt;
+        if (f.len > 8) f.flags |= bus::Frame::kFd;
+        db.encode(&m, values, std::span<uint8_t>(f.data, f.len));
+        frames.push_back(f);
+    }
+    if (frames.empty()) {
+        std::cerr << "[vscan_bench] Seçilen mesaj DBC'de yok\n";
+        return 1;
+    }
+
+    const std::size_t n = opt.iterations;
+    std::size_t sink = 0;
+
+    // FrameSerializer: dinleyicideki gibi tek resolve + decode; MQTT için sıkışık
+    // kayıt, echo açıksa konsol için ayrıca girintili kayıt
+    util::FrameSerializer compact, pretty(true);
+    dbc::DecodedSignals sigs(db.maxSignalsPerMessage());
+    auto runSerializer = [&](bool echo) {
+        const auto t0 = Clock::now();
+        for (std::size_t i = 0; i < n; ++i) {
+            bus::Frame& f = frames[i % frames.size()];
+            f.ts = std::chrono::microseconds(static_cast<int64_t>(i));
+            const dbc::MessageHandle msg = db.resolve(f.id);
+            db.decode(msg, f.payload(), sigs);
+            sink += compact.serialize(f, "can0", db, msg, sigs).size();
+            if (echo) sink += pretty.serialize(f, "can0", db, msg, sigs).size();
+        }
+        return nsPerFrame(Clock::now() - t0, n);
+    };
+
+    // Eski yol: isim-değer haritası, nlohmann::json, MQTT için dump(2); eski
+    // sürüm konsola da her zaman aynı dump(2)'yi basıyordu
+    nlohmann::json j;
+    std::map<std::string, double> named;
+    auto runLegacy = [&](bool echo) {
+        const auto t0 = Clock::now();
+        for (std::size_t i = 0; i < n; ++i) {
+            bus::Frame& f = frames[i % frames.size()];
+            f.ts = std::chrono::microseconds(static_cast<int64_t>(i));
+            const dbc::MessageHandle msg = db.resolve(f.id);
+            j["ts"] = f.ts.count();
+            j["bus"] = "can0";
+            j["id"] = f.rawId();
+            j["dlc"] = static_cast<int>(f.len);
+            j["raw"] = toHex(f.data, f.len);
+            j["name"] = msg ? msg->name : "";
+            named.clear();
+            db.decode(msg, f.payload(), named);
+            j["signals"] = named;
+            sink += j.dump(2).size();
+            if (echo) sink += j.dump(2).size();
+        }
+        return nsPerFrame(Clock::now() - t0, n);
+    };
+
+    // Aynı iş iki yanda: yalnız MQTT (echo=0, varsayılan) ve MQTT + konsol (echo=1)
+    const double fresh = runSerializer(false), legacy = runLegacy(false);
+    const double freshEcho = runSerializer(true), legacyEcho = runLegacy(true);
+    std::cout << fmt::format("[vscan_bench] {} mesaj, {} frame/yol (çıktı {} bayt)\n", frames.size(), n, sink)
+              << fmt::format("  yalnız MQTT      FrameSerializer  {:8.0f} ns/frame   nlohmann + dump(2)     {:8.0f} ns/frame  (x{:.1f})\n",
+                             fresh, legacy, legacy / fresh)
+              << fmt::format("  MQTT + konsol    FrameSerializer  {:8.0f} ns/frame   nlohmann + 2x dump(2)  {:8.0f} ns/frame  (x{:.1f})\n",
+                             freshEcho, legacyEcho, legacyEcho / freshEcho);
+    return 0;
+}
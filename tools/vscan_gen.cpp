@@ -0,0 +1,307 @@
+// tools/vscan_gen.cpp
+// DBC'den gerçekçi sinyal dalga biçimleriyle CAN trafiği üretir ve SocketCAN
+// (vcan) arayüzüne sendmmsg ile basar. Dinleyicinin yük/dayanıklılık testleri için.
+//
+//   vscan_gen -i vcan0 -d conf/j1939.dbc [-m EEC1,CCVS1] [-r 5000 | -l 60]
+//             [-b 500000] [-B 2000000] [-t 60] [-s 0x21]
+#include "bus/can_channel.hpp"
+#include "dbc/dbc_database.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <numbers>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <fmt/core.h>
+#ifdef __linux__
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace dbc = canmqtt::dbc;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+std::atomic<bool> g_stop {false};
+
+struct Options {
+    std::string iface = "vcan0";
+    std::string dbcFile = "../conf/j1939.dbc";
+    std::vector<std::string> messages;      ///< boş: DBC'deki tüm mesajlar
+    double rate = 1000.0;                   ///< frame/s
+    double load = 0.0;                      ///< > 0 ise rate bu bus yükünden hesaplanır (%)
+    double bitrate = 500000.0;
+    double dataBitrate = 2000000.0;         ///< FD veri fazı (BRS)
+    double duration = 0.0;                  ///< sn; 0 = Ctrl+C'ye kadar
+    int sa = -1;                            ///< >= 0 ise 29-bit ID'lerde kaynak adres
+};
+
+void usage()
+{
+    std::cerr <<
+        "Kullanım: vscan_gen [seçenekler]\n"
+        "  -i <arayüz>     SocketCAN arayüzü (varsayılan vcan0)\n"
+        "  -d <dbc>        DBC dosyası\n"
+        "  -m <a,b,..>     gönderilecek mesaj adları (varsayılan: hepsi)\n"
+        "  -r <fps>        frame/s (varsayılan 1000)\n"
+        "  -l <yüzde>      hedef bus yükü; verilirse -r yerine kullanılır\n"
+        "  -b <bit/s>      yük hesabı için nominal bitrate (varsayılan 500000)\n"
+        "  -B <bit/s>      yük hesabı için FD veri fazı bitrate'i (varsayılan 2000000)\n"
+        "  -t <sn>         süre (0: Ctrl+C'ye kadar)\n"
+        "  -s <hex>        29-bit ID'lerde kaynak adres (SA)\n";
+}
+
+std::vector<std::string> splitList(std::string_view s)
+{
+    std::vector<std::string> out;
+    while (!s.empty()) {
+        const auto comma = s.find(',');
+        if (comma != 0) out.emplace_back(s.substr(0, comma));
+        if (comma == std::string_view::npos) break;
+        s.remove_prefix(comma + 1);
+    }
+    return out;
+}
+
+bool parseArgs(int argc, char** argv, Options& o)
+{
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view a = argv[i];
+            if (a == "-h" || a == "--help") return false;
+            if (i + 1 >= argc) return false;
+            const std::string v = argv[++i];
+            if      (a == "-i") o.iface = v;
+            else if (a == "-d") o.dbcFile = v;
+            else if (a == "-m") o.messages = splitList(v);
+            else if (a == "-r") o.rate = std::stod(v);
+            else if (a == "-l") o.load = std::stod(v);
+            else if (a == "-b") o.bitrate = std::stod(v);
+            else if (a == "-B") o.dataBitrate = std::stod(v);
+            else if (a == "-t") o.duration = std::stod(v);
+            else if (a == "-s") o.sa = std::stoi(v, nullptr, 16) & 0xFF;
+            else return false;
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return o.rate > 0 && o.load >= 0 && o.load <= 100 && o.bitrate > 0 && o.dataBitrate > 0;
+}
+
+/// Frame'in nominal bit zamanı cinsinden uzunluğu, bit doldurma en kötü durumda.
+/// Klasik: 11-bit 47 + 8n + ⌊(34+8n-1)/4⌋, 29-bit 67 + 8n + ⌊(54+8n-1)/4⌋.
+/// FD (n > 8, BRS): tahkim 17/36 bit + doldurma ve ACK/EOF/IFS 12 bit nominal hızda;
+/// ESI+DLC+veri, dinamik doldurmanın kalanı, stuff count (4), CRC 17/21 (n ≤ 16 / > 16),
+/// sabit doldurma 6/7 ve CRC ayracı veri hızında. Veri fazı nominal/veri oranıyla ölçeklenir.
+/// Yük buna göre hesaplandığından gerçek yük biraz altında kalır.
+double frameBits(bool extended, std::size_t len, double bitrate, double dataBitrate)
+{
+    const double n = static_cast<double>(len);
+    if (len <= 8)
+        return extended ? 67 + 8 * n + std::floor((54 + 8 * n - 1) / 4)
+                        : 47 + 8 * n + std::floor((34 + 8 * n - 1) / 4);
+
+    const double arb = extended ? 36 : 17;                    // SOF..BRS
+    const double field = 5 + 8 * n;                           // ESI + DLC + veri
+    const double arbStuff = std::floor((arb - 1) / 4);
+    const double dataStuff = std::floor((arb + field - 1) / 4) - arbStuff;
+    const bool crc21 = len > 16;
+    const double dataPhase = field + dataStuff + 4 + (crc21 ? 21 : 17) + (crc21 ? 7 : 6) + 1;
+    return arb + arbStuff + 12 + dataPhase * bitrate / dataBitrate;
+}
+
+/// Sinyal başına dalga biçimi: indekse göre sinüs, testere, kare ya da rastgele yürüyüş;
+/// periyotlar farklı olsun diye 2..20 sn arasında dağıtılır. Sonuç [0, 1].
+class Waveforms {
+public:
+    explicit Waveforms(std::size_t signals) : walk_(signals, 0.5), seed_(0x2545F4914F6CDD1Dull) {}
+
+    double at(uint32_t sig, double t)
+    {
+        const double period = 2.0 + (sig * 7u) % 19u;
+        const double phase = std::fmod(t / period, 1.0);
+        switch (sig % 4) {
+        case 0:  return 0.5 + 0.5 * std::sin(2 * std::numbers::pi * phase);
+        case 1:  return phase;
+        case 2:  return phase < 0.5 ? 0.0 : 1.0;
+        default: {
+            double& w = walk_[sig];
+            w = std::clamp(w + (uniform() - 0.5) * 0.02, 0.0, 1.0);
+            return w;
+        }
+        }
+    }
+
+private:
+    double uniform()
+    {
+        seed_ ^= seed_ >> 12; seed_ ^= seed_ << 25; seed_ ^= seed_ >> 27;        // xorshift64*
+        return static_cast<double>((seed_ * 0x2545F4914F6CDD1Dull) >> 11) * 0x1.0p-53;
+    }
+
+    std::vector<double> walk_;
+    uint64_t seed_;
+};
+
+/// Gönderilecek payload boyu: DBC boyu; 8'i aşıyorsa geçerli bir FD uzunluğuna
+/// (12, 16, 20, 24, 32, 48, 64) yukarı yuvarlanır, yoksa kernel frame'i reddeder
+std::size_t frameLength(dbc::MessageHandle m)
+{
+    const std::size_t size = std::min<std::size_t>(m->size, canmqtt::bus::Frame::kMaxData);
+    return size <= 8 ? size : canmqtt::bus::FdDlcToLen(canmqtt::bus::FdLenToDlc(size));
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+#ifndef __linux__
+    (void)argc; (void)argv;
+    std::cerr << "[vscan_gen] Yalnızca Linux (SocketCAN) desteklenir\n";
+    return 1;
+#else
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        usage();
+        return 2;
+    }
+
+    dbc::DbcDatabase db;
+    if (!db.load(opt.dbcFile)) return 1;
+
+    std::vector<dbc::MessageHandle> msgs;
+    for (const auto& m : db.messages())
+        if (opt.messages.empty() || std::find(opt.messages.begin(), opt.messages.end(), m.name) != opt.messages.end())
+            msgs.push_back(&m);
+    if (msgs.empty()) {
+        std::cerr << "[vscan_gen] Seçilen mesaj DBC'de yok\n";
+        return 1;
+    }
+
+    const bool needFd = std::any_of(msgs.begin(), msgs.end(), [](dbc::MessageHandle m) { return m->size > CAN_MAX_DLEN; });
+    double meanBits = 0;
+    for (auto m : msgs) meanBits += frameBits(m->extended, frameLength(m), opt.bitrate, opt.dataBitrate);
+    meanBits /= static_cast<double>(msgs.size());
+    const double rate = opt.load > 0 ? opt.load / 100.0 * opt.bitrate / meanBits : opt.rate;
+
+    // ───── soket ─────
+    const int fd = ::socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if (fd < 0) { std::perror("socket"); return 1; }
+    ifreq ifr {};
+    std::strncpy(ifr.ifr_name, opt.iface.c_str(), IFNAMSIZ - 1);
+    if (::ioctl(fd, SIOCGIFINDEX, &ifr) < 0) { std::perror("SIOCGIFINDEX"); return 1; }
+    sockaddr_can addr {};
+    addr.can_family  = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) { std::perror("bind"); return 1; }
+    // Yalnızca gönderir: alım kuyruğu hiç dolmasın
+    ::setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FILTER, nullptr, 0);
+    if (needFd) {
+        int on = 1;
+        if (::setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &on, sizeof(on)) < 0) {
+            std::perror("CAN_RAW_FD_FRAMES");
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT,  [](int) { g_stop = true; });
+    std::signal(SIGTERM, [](int) { g_stop = true; });
+
+    std::cout << fmt::format("[vscan_gen] {} mesaj → {} @ {:.0f} fps (ortalama {:.0f} bit/frame, ~%{:.1f} yük @ {:.0f} bit/s)",
+                             msgs.size(), opt.iface, rate, meanBits, rate * meanBits / opt.bitrate * 100.0, opt.bitrate)
+              << std::endl;
+
+    // ───── gönderim döngüsü ─────
+    constexpr std::size_t kBatch = 64;
+    std::vector<canfd_frame> frames(kBatch);
+    std::vector<iovec> iov(kBatch);
+    std::vector<mmsghdr> hdr(kBatch);
+    for (std::size_t k = 0; k < kBatch; ++k) {
+        iov[k].iov_base = &frames[k];
+        hdr[k].msg_hdr.msg_iov = &iov[k];
+        hdr[k].msg_hdr.msg_iovlen = 1;
+    }
+
+    std::vector<double> values(db.maxSignalsPerMessage());
+    Waveforms wave(db.signalCount());
+    const auto& plan = db.plan();
+
+    // Düşük hızda frame'ler tek tek aralıklı, yüksek hızda ~1 ms'lik gruplar halinde
+    const std::size_t perBatch = std::clamp<std::size_t>(static_cast<std::size_t>(rate / 1000.0), 1, kBatch);
+    const auto start = Clock::now();
+    auto lastReport = start;
+    uint64_t sent = 0, lastSent = 0, noBufs = 0;
+    std::size_t next = 0;
+
+    while (!g_stop) {
+        const auto due = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(sent / rate));
+        std::this_thread::sleep_until(due);
+        const double t = std::chrono::duration<double>(Clock::now() - start).count();
+        if (opt.duration > 0 && t >= opt.duration) break;
+
+        for (std::size_t k = 0; k < perBatch; ++k) {
+            const dbc::MessageHandle m = msgs[next];
+            next = (next + 1) % msgs.size();
+
+            for (uint32_t s = 0; s < m->signal_count; ++s) {
+                const uint32_t sig = m->first_signal + s;
+                const auto [lo, hi] = plan.range(sig);
+                values[s] = lo + (hi - lo) * wave.at(sig, t);
+            }
+
+            canfd_frame& f = frames[k];
+            std::memset(&f, 0, sizeof(f));
+            const std::size_t len = frameLength(m);
+            db.encode(m, values, std::span<uint8_t>(f.data, len));        // DBC boyundan sonrası sıfır dolgu
+            f.len = static_cast<uint8_t>(len);
+            uint32_t id = m->id;
+            if (m->extended && opt.sa >= 0) id = (id & ~0xFFu) | static_cast<uint32_t>(opt.sa);
+            f.can_id = m->extended ? (id | CAN_EFF_FLAG) : id;
+            if (len > CAN_MAX_DLEN) f.flags = CANFD_BRS;
+            iov[k].iov_len = len > CAN_MAX_DLEN ? CANFD_MTU : CAN_MTU;
+        }
+
+        // Arayüz kuyruğu doluysa (ENOBUFS) kısa bekleyip kalanları yeniden dene
+        std::size_t done = 0;
+        while (done < perBatch && !g_stop) {
+            const int n = ::sendmmsg(fd, hdr.data() + done, static_cast<unsigned>(perBatch - done), 0);
+            if (n > 0) { done += static_cast<std::size_t>(n); continue; }
+            if (errno == ENOBUFS || errno == EAGAIN || errno == EINTR) {
+                ++noBufs;
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                continue;
+            }
+            std::perror("sendmmsg");
+            g_stop = true;
+        }
+        sent += done;
+
+        const auto now = Clock::now();
+        if (now - lastReport >= std::chrono::seconds(1)) {
+            const double secs = std::chrono::duration<double>(now - lastReport).count();
+            const double fps = (sent - lastSent) / secs;
+            std::cout << fmt::format("[vscan_gen] {:.0f} fps, ~%{:.1f} yük, ENOBUFS {}", fps, fps * meanBits / opt.bitrate * 100.0, noBufs)
+                      << std::endl;
+            lastReport = now;
+            lastSent = sent;
+        }
+    }
+
+    ::close(fd);
+    const double total = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << fmt::format("[vscan_gen] Toplam {} frame, {:.1f} sn ({:.0f} fps)", sent, total, total > 0 ? sent / total : 0.0) << std::endl;
+    return 0;
+#endif
+}
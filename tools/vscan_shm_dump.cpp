@@ -0,0 +1,62 @@
+// tools/vscan_shm_dump.cpp
+// vsCANView'in paylaşılan bellek son-değer tablosunu ([shm] enable=1) okuyup
+// basar. vscan_shm okuyucu kütüphanesinin örnek kullanımı.
+//
+//   vscan_shm_dump [-n /vscan_latest] [-w ms] [filtre]
+#include "shm/latest_reader.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace shm = canmqtt::shm;
+
+int main(int argc, char** argv)
+{
+    std::string name = shm::kDefaultName;
+    int watchMs = 0;                        // > 0: bu aralıkla yeniden bas
+    std::string filter;                     // mesaj ya da sinyal adında geçen metin
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view a = argv[i];
+        if (a == "-n" && i + 1 < argc) name = argv[++i];
+        else if (a == "-w" && i + 1 < argc) watchMs = std::atoi(argv[++i]);
+        else if (a == "-h" || a == "--help") {
+            std::cerr << "Kullanım: vscan_shm_dump [-n ad] [-w ms] [filtre]\n";
+            return 0;
+        } else filter = a;
+    }
+
+    shm::LatestReader reader;
+    for (;;) {
+        // Yazar DBC değiştirdi ya da yeniden başladı: yeni segmente geç
+        if ((reader.stale() && !reader.open(name)) || !reader.isOpen()) {
+            std::cerr << name << " açılamadı (vsCANView [shm] enable=1 ile çalışıyor mu?)\n";
+            if (watchMs <= 0) return 1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(watchMs));
+            continue;
+        }
+
+        const auto now = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        shm::LatestReader::Value v;
+        for (uint32_t i = 0; i < reader.size(); ++i) {
+            if (!filter.empty() && reader.message(i).find(filter) == std::string_view::npos &&
+                reader.signal(i).find(filter) == std::string_view::npos)
+                continue;
+            if (!reader.read(i, v)) continue;
+            const auto bus = reader.bus(i), msg = reader.message(i), sig = reader.signal(i);
+            std::printf("%-8.*s %-20.*s %-36.*s %14g  id=%08X  %7.3f s önce  (%llu)\n",
+                        static_cast<int>(bus.size()), bus.data(), static_cast<int>(msg.size()), msg.data(),
+                        static_cast<int>(sig.size()), sig.data(), v.value, v.canId,
+                        (now - v.ts) / 1e6, static_cast<unsigned long long>(v.updates));
+        }
+        if (watchMs <= 0) return 0;
+        std::printf("\n");
+        std::fflush(stdout);
+        std::this_thread::sleep_for(std::chrono::milliseconds(watchMs));
+    }
+}
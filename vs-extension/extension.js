@@ -1,6 +1,7 @@
 const vscode = require('vscode');
 const mqtt = require('mqtt');
 const fs = require('fs');
+const { isBinaryPayload, setSchema, decodeBinaryPayload } = require('./src/utils/binaryPayload');
 
 let client = null;
 
@@ -75,16 +76,30 @@ function ensureMqtt(context) {
 
   c.on('message', (topic, p) => {
     let obj = null;
-    const rawMessage = p.toString('utf8');
-    
-    try {
-      obj = JSON.parse(rawMessage);
-    } catch (e) {
-      console.error('❌ MQTT message parsing error:', e);
-      return;
+
+    if (isBinaryPayload(p)) {
+      obj = decodeBinaryPayload(topic, p);
+      if (!obj) return;
+    } else {
+      const rawMessage = p.toString('utf8');
+      
+      try {
+        obj = JSON.parse(rawMessage);
+      } catch (e) {
+        console.error('❌ MQTT message parsing error:', e);
+        return;
+      }
+
+      // İkili yükün sinyal/mesaj adları (retained)
+      if (topic.endsWith('/schema')) {
+        setSchema(topic.split('/')[1] || '', obj);
+        return;
+      }
     }
     
-    if (obj) {
+    if (obj && Array.isArray(obj.frames)) {
+      handleBatch(topic, obj);
+    } else if (obj) {
       postAll({ type: 'can', topic, payload: obj });
     }
   });
@@ -99,6 +114,27 @@ function ensureMqtt(context) {
   return client;
 }
 
+// Toplu mesajlar (can/<bus>/batch): (bus, stream) başına seq ile boşluk tespiti, sonra frame'leri tek tek ilet
+const lastBatchSeq = new Map();
+function handleBatch(topic, batch) {
+  const bus = batch.bus || topic.split('/')[1] || '';
+  if (typeof batch.seq === 'number') {
+    const stream = typeof batch.stream === 'number' ? batch.stream : 0;
+    const key = `${bus}/${stream}`;
+    const prev = lastBatchSeq.get(key);
+    if (prev !== undefined && batch.seq > prev + 1) {
+      const missing = batch.seq - prev - 1;
+      console.warn(`⚠️ MQTT batch gap on ${bus} (stream ${stream}): ${missing} batch(es) missing (seq ${prev} -> ${batch.seq})`);
+      postAll({ type: 'gap', bus, stream, missing, from: prev, to: batch.seq });
+    }
+    lastBatchSeq.set(key, batch.seq);
+  }
+  for (const frame of batch.frames) {
+    const id = typeof frame.id === 'number' ? frame.id.toString(16).toUpperCase().padStart(6, '0') : '';
+    postAll({ type: 'can', topic: `can/${bus}/${id}`, payload: frame });
+  }
+}
+
 function postAll(msg){ 
   if (Dashboard.instance) Dashboard.instance.post(msg); 
 }
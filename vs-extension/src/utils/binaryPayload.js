@@ -0,0 +1,135 @@
+/**
+ * Decoder for the compact binary MQTT payload ([mqtt] format=binary).
+ * Layout is documented in docs/binary_payload.md.
+ */
+
+const MAGIC0 = 0x56; // 'V'
+const MAGIC1 = 0x43; // 'C'
+const VERSION = 2;      // 1 is accepted too: it only lacks FLAG_TP records
+const KIND_FRAME = 1;
+const KIND_BATCH = 2;
+const NO_MESSAGE = 0xFFFF;
+const VALUE_F64 = 0x8000;
+const FLAG_TP = 0x40;    // reassembled J1939 TP message: u16 length follows the meta bytes
+const HEADER_SIZE = 8;
+
+// bus -> { fingerprint, messages, signals } from the retained can/<bus>/schema topic
+const schemas = new Map();
+const warnedMismatch = new Set();
+
+/**
+ * Checks the magic bytes of a raw MQTT payload
+ *
+ * @param {Buffer} buf - The raw MQTT payload
+ * @returns {boolean} True if the payload is in the binary format
+ */
+function isBinaryPayload(buf) {
+    return buf.length >= HEADER_SIZE && buf[0] === MAGIC0 && buf[1] === MAGIC1;
+}
+
+/**
+ * Stores the schema published on can/<bus>/schema
+ *
+ * @param {string} bus - Bus name taken from the topic
+ * @param {object} schema - Parsed schema JSON
+ */
+function setSchema(bus, schema) {
+    if (!schema || !Array.isArray(schema.signals)) return;
+    schemas.set(bus, schema);
+    warnedMismatch.delete(bus);
+}
+
+function readRecord(buf, off, end, bus, schema) {
+    const ts = Number(buf.readBigUInt64LE(off));
+    const id = buf.readUInt32LE(off + 8);
+    const msgIdx = buf.readUInt16LE(off + 12);
+    const flags = buf[off + 14];
+    let len = buf[off + 16];
+    const nsig = buf[off + 17];
+    off += 18;
+    if (flags & FLAG_TP) {
+        len = buf.readUInt16LE(off);
+        off += 2;
+    }
+    if (off + len > end) throw new RangeError('truncated record');
+
+    const data = buf.subarray(off, off + len);
+    off += len;
+
+    const signals = {};
+    for (let i = 0; i < nsig; ++i) {
+        const tag = buf.readUInt16LE(off);
+        const idx = tag & ~VALUE_F64;
+        let value;
+        if (tag & VALUE_F64) {
+            value = buf.readDoubleLE(off + 2);
+            off += 10;
+        } else {
+            value = buf.readFloatLE(off + 2);
+            off += 6;
+        }
+        const name = schema && schema.signals[idx] !== undefined ? schema.signals[idx] : `#${idx}`;
+        signals[name] = value;
+    }
+
+    const frame = {
+        ts,
+        bus,
+        id,
+        dlc: len,
+        raw: Array.from(data, b => b.toString(16).toUpperCase().padStart(2, '0')).join(' '),
+        name: schema && msgIdx !== NO_MESSAGE ? (schema.messages[msgIdx] || '') : ''
+    };
+    if (nsig) frame.signals = signals;
+    return { frame, next: off };
+}
+
+/**
+ * Decodes a binary payload into the same shape the JSON payload has
+ *
+ * @param {string} topic - MQTT topic (can/<bus>/...)
+ * @param {Buffer} buf - The raw MQTT payload
+ * @returns {object|null} A single frame object, a batch {seq, stream, bus, count, frames}, or null if invalid
+ */
+function decodeBinaryPayload(topic, buf) {
+    if (!isBinaryPayload(buf) || buf[2] < 1 || buf[2] > VERSION) return null;
+    const kind = buf[3];
+    const fingerprint = buf.readUInt32LE(4);
+    const bus = topic.split('/')[1] || '';
+
+    const schema = schemas.get(bus);
+    if (schema && schema.fingerprint !== fingerprint && !warnedMismatch.has(bus)) {
+        console.warn(`⚠️ Binary payload on ${bus} uses DBC fingerprint ${fingerprint}, schema has ${schema.fingerprint}`);
+        warnedMismatch.add(bus);
+    }
+    const names = schema && schema.fingerprint === fingerprint ? schema : null;
+
+    try {
+        if (kind === KIND_FRAME) {
+            return readRecord(buf, HEADER_SIZE, buf.length, bus, names).frame;
+        }
+        if (kind === KIND_BATCH) {
+            const seq = buf.readUInt32LE(HEADER_SIZE);
+            const count = buf.readUInt16LE(HEADER_SIZE + 4);
+            const stream = buf.readUInt16LE(HEADER_SIZE + 6);
+            const frames = [];
+            let off = HEADER_SIZE + 8;
+            for (let i = 0; i < count; ++i) {
+                const size = buf.readUInt16LE(off);
+                off += 2;
+                frames.push(readRecord(buf, off, off + size, bus, names).frame);
+                off += size;
+            }
+            return { seq, stream, bus, count, frames };
+        }
+    } catch (e) {
+        console.error('❌ Binary payload decode error:', e);
+    }
+    return null;
+}
+
+module.exports = {
+    isBinaryPayload,
+    setSchema,
+    decodeBinaryPayload
+};